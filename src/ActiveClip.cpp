@@ -1,7 +1,10 @@
 #include "ActiveClip.h"
 
+#include "AnimationLoader.h"
+#include "ConditionFactCache.h"
 #include "Offsets.h"
 #include "OpenAnimationReplacer.h"
+#include "PoseBlending.h"
 #include "Settings.h"
 
 #include <ranges>
@@ -23,6 +26,7 @@ ActiveClip::ActiveClip(RE::hkbClipGenerator* a_clipGenerator, RE::hkbCharacter*
 	_clipGenerator(a_clipGenerator),
 	_character(a_character),
 	_behaviorGraph(a_behaviorGraph),
+	_clipNameID(OpenAnimationReplacer::GetSingleton().GetClipNameID(a_clipGenerator->name.data())),
 	_originalIndex(a_clipGenerator->animationBindingIndex),
 	_originalMode(*a_clipGenerator->mode),
 	_originalFlags(a_clipGenerator->flags),
@@ -30,6 +34,9 @@ ActiveClip::ActiveClip(RE::hkbClipGenerator* a_clipGenerator, RE::hkbCharacter*
 	_bOriginalReplaceOnEcho(OpenAnimationReplacer::GetSingleton().ShouldOriginalAnimationReplaceOnEcho(a_character, a_clipGenerator->animationBindingIndex))
 {
 	_refr = Utils::GetActorFromHkbCharacter(a_character);
+	if (_refr) {
+		_refHandle = _refr->GetHandle();
+	}
 }
 
 ActiveClip::~ActiveClip()
@@ -107,6 +114,8 @@ void ActiveClip::ReplaceAnimation(ReplacementAnimation* a_replacementAnimation,
 			_clipGenerator->flags &= ~0x10;
 		}
 
+		AnimationLoader::GetSingleton().MarkUsed(_character, newBindingIndex);
+
 		// handle variant data
 		if (_currentReplacementAnimation->HasVariants()) {
 			const auto& variants = _currentReplacementAnimation->GetVariants();
@@ -162,7 +171,7 @@ void ActiveClip::ReplaceActiveAnimation(RE::hkbClipGenerator* a_clipGenerator, c
 		startTime = a_clipGenerator->animationControl->localTime;
 	}
 
-	if (blendTime > 0.f) {
+	if (blendTime > 0.f && GetBlendLOD() != BlendLOD::kHardCut) {
 		StartBlend(a_clipGenerator, a_context, blendTime);
 
 		// set to null before deactivation so it isn't destroyed when hkbClipGenerator::Deactivate is called (we continue using this animation control object in the fake clip generator)
@@ -246,6 +255,8 @@ void ActiveClip::PreUpdate(RE::hkbClipGenerator* a_clipGenerator, const RE::hkbC
 		return;  // Analogous function already ran by ActiveSynchronizedAnimation
 	}
 
+	MarkAnimationsInUse(a_timestep);
+
 	bool bIsLoopingThisUpdate = false;
 	if (a_clipGenerator->mode == RE::hkbClipGenerator::PlaybackMode::kModeLooping) {
 		float prevLocalTime = 0.f;
@@ -260,7 +271,7 @@ void ActiveClip::PreUpdate(RE::hkbClipGenerator* a_clipGenerator, const RE::hkbC
 
 	if (!IsReadyToReplace(bIsLoopingThisUpdate)) {
 		// check if the animation should be interrupted (queue a replacement if so)
-		if (IsInterruptible()) {
+		if (IsInterruptible() && ShouldEvaluateInterrupt(a_timestep)) {
 			const auto newReplacementAnim = OpenAnimationReplacer::GetSingleton().GetReplacementAnimation(a_context.character, a_clipGenerator, _originalIndex);
 			// do not try to replace with other variants here
 			Variant* dummy = nullptr;
@@ -335,12 +346,19 @@ void ActiveClip::PreUpdate(RE::hkbClipGenerator* a_clipGenerator, const RE::hkbC
 	}
 
 	// replace anim if queued
-	if (IsReadyToReplace(bIsLoopingThisUpdate)) {
+	if (IsReadyToReplace(bIsLoopingThisUpdate) && IsQueuedReplacementLoaded(a_timestep)) {
 		ReplaceActiveAnimation(a_clipGenerator, a_context);
 	}
 
 	// update blending clips and remove those expired
 	if (IsBlending()) {
+		_blendLOD = GetBlendLOD();
+		if (_blendLOD == BlendLOD::kHardCut) {
+			// moved too far away mid blend, just finish it now
+			_blendingClipGenerators.clear();
+			return;
+		}
+
 		const float currentGameTime = OpenAnimationReplacer::gameTimeCounter;
 		const float deltaTime = currentGameTime - _lastGameTime;
 		_lastGameTime = currentGameTime;
@@ -371,13 +389,22 @@ void ActiveClip::OnActivate(RE::hkbClipGenerator* a_clipGenerator, const RE::hkb
 			}
 			if (const auto replacementAnimation = replacements->EvaluateConditionsAndGetReplacementAnimation(refr, a_clipGenerator)) {
 				Variant* variant = nullptr;
-				[[maybe_unused]] const uint16_t newVariantIndex = replacementAnimation->GetIndex(this, variant);
-				ReplaceAnimation(replacementAnimation, variant);
-
-				if (_currentReplacementAnimation && _currentReplacementAnimation->GetTriggersFromAnnotationsOnly()) {
-					BackupTriggers(a_clipGenerator);
+				const uint16_t newVariantIndex = replacementAnimation->GetIndex(this, variant);
+				if (AnimationLoader::ShouldLoadOnDemand() && !AnimationLoader::GetSingleton().RequestAnimation(a_context.character, newVariantIndex)) {
+					// lazy loading - keep playing the original animation until the replacement is loaded, then blend into it
+					QueueReplacementAnimation(replacementAnimation, Settings::fDefaultBlendTimeOnLazyLoad, QueuedReplacement::Type::kContinue, AnimationLogEntry::Event::kActivateReplace, variant);
+				} else {
+					ReplaceAnimation(replacementAnimation, variant);
+
+					if (_currentReplacementAnimation && _currentReplacementAnimation->GetTriggersFromAnnotationsOnly()) {
+						BackupTriggers(a_clipGenerator);
+					}
 				}
 			}
+
+			if (AnimationLoader::ShouldLoadOnDemand()) {
+				PrefetchLikelyReplacements();
+			}
 		}
 	}
 }
@@ -448,11 +475,14 @@ void ActiveClip::OnGenerate([[maybe_unused]] RE::hkbClipGenerator* a_clipGenerat
 
 		auto poseOut = poseTrack.GetDataQsTransform();
 
-		std::vector<RE::hkQsTransform> blendedTracks{};
-		if (GetBlendedTracks(blendedTracks)) {
-			float lerpAmount = std::clamp(Utils::InterpEaseInOut(0.f, 1.f, GetBlendWeight(), 2), 0.f, 1.f);
-			auto numBlend = std::min(static_cast<size_t>(poseTrack.GetNumData()), blendedTracks.size());
-			hkbBlendPoses(numBlend, poseOut, blendedTracks.data(), lerpAmount, poseOut);
+		uint32_t maxTracks = _blendLOD == BlendLOD::kReduced ? Settings::uBlendLODReducedTrackCount : std::numeric_limits<uint32_t>::max();
+		if (a_context.character->numTracksInLOD > -1) {
+			maxTracks = std::min(maxTracks, static_cast<uint32_t>(a_context.character->numTracksInLOD));
+		}
+
+		if (SampleBlendingPoses(maxTracks)) {
+			static_assert(sizeof(RE::hkQsTransform) == PoseBlending::kFloatsPerTransform * sizeof(float));
+			PoseBlending::BlendPoseStack(_blendPoses.data(), _blendTrackCounts.data(), _blendAmounts.data(), _blendPoses.size(), poseTrack.GetNumData(), reinterpret_cast<float*>(poseOut));
 		}
 	}
 }
@@ -482,7 +512,7 @@ bool ActiveClip::IsInLoopSequence()
 		const auto& variants = _currentReplacementAnimation->GetVariants();
 		// check if the variant sequence has finished
 		if (const auto stateData = variants.TryGetVariantStateData(this)) {
-			return !stateData->IsAtBeginningOfSequence(_clipGenerator, &variants);
+			return !stateData->IsAtBeginningOfSequence(this, &variants);
 		}
 	}
 
@@ -501,7 +531,7 @@ bool ActiveClip::OnLoopOrEcho(RE::hkbClipGenerator* a_clipGenerator, bool a_bIsE
 	if (bHasVariants) {
 		const auto& variants = _currentReplacementAnimation->GetVariants();
 		if (const auto stateData = variants.GetVariantStateData(this)) {
-			bContinueVariantSequence = !bShouldReplace || !stateData->IsAtBeginningOfSequence(_clipGenerator, &variants);
+			bContinueVariantSequence = !bShouldReplace || !stateData->IsAtBeginningOfSequence(this, &variants);
 		}
 	}
 
@@ -568,60 +598,182 @@ void ActiveClip::RemoveNonAnnotationTriggersFromClipTriggerArray(RE::hkRefPtr<RE
 	_bRemovedNonAnnotationTriggers = true;
 }
 
-bool ActiveClip::GetBlendedTracks(std::vector<RE::hkQsTransform>& a_outBlendedTracks)
+bool ActiveClip::ShouldEvaluateInterrupt(float a_timestep)
 {
-	if (_blendingClipGenerators.empty()) {
+	const float interval = HasReplacementAnimation() ? GetReplacementAnimation()->GetParentSubMod()->GetInterruptEvaluationInterval() : 0.f;
+	if (interval <= 0.f) {
+		return true;
+	}
+
+	_timeSinceInterruptEvaluation += a_timestep;
+
+	// check early if any cached fact about the refr was invalidated since the last check, as the conditions might depend on it
+	const uint64_t factGeneration = ConditionFactCache::GetSingleton().GetRefrGeneration(_refr);
+	if (_timeSinceInterruptEvaluation < interval && factGeneration == _interruptFactGeneration) {
 		return false;
 	}
 
-	auto getTracks = [](const auto& a_blendingClip, std::vector<RE::hkQsTransform>& a_sampledTracks) {
-		if (const auto binding = a_blendingClip->clipGenerator.animationControl->binding) {
-			if (const auto& blendFromAnimation = binding->animation) {
-				a_sampledTracks.resize(blendFromAnimation->numberOfTransformTracks);
-				std::vector<float> sampledFloatTracks{};
-				sampledFloatTracks.resize(blendFromAnimation->numberOfFloatTracks);
+	_timeSinceInterruptEvaluation = 0.f;
+	_interruptFactGeneration = factGeneration;
 
-				blendFromAnimation->SamplePartialTracks(a_blendingClip->clipGenerator.localTime, blendFromAnimation->numberOfTransformTracks, a_sampledTracks.data(), blendFromAnimation->numberOfFloatTracks, sampledFloatTracks.data(), nullptr);
+	return true;
+}
 
-				return true;
-			}
+bool ActiveClip::IsQueuedReplacementLoaded(float a_timestep)
+{
+	if (!AnimationLoader::ShouldLoadOnDemand()) {
+		return true;
+	}
+
+	auto& queuedReplacement = *_queuedReplacement;
+
+	uint16_t index = _originalIndex;
+	if (const auto replacementAnimation = queuedReplacement.replacementAnimation) {
+		// pick the variant now, so the one that gets loaded is also the one that plays
+		index = queuedReplacement.variant ? queuedReplacement.variant->GetIndex() : replacementAnimation->GetIndex(this, queuedReplacement.variant);
+	}
+
+	if (AnimationLoader::GetSingleton().RequestAnimation(_character, index)) {
+		_lazyLoadWaitTime = 0.f;
+		return true;
+	}
+
+	// don't wait forever if the file fails to load for whatever reason
+	_lazyLoadWaitTime += a_timestep;
+	if (_lazyLoadWaitTime > Settings::fLazyLoadMaxWaitTime) {
+		_lazyLoadWaitTime = 0.f;
+		return true;
+	}
+
+	return false;
+}
+
+void ActiveClip::MarkAnimationsInUse(float a_timestep)
+{
+	if (!Settings::bEnableAnimationEviction) {
+		return;
+	}
+
+	// the evictor only looks at animations that went unused for much longer than its check interval, so refreshing them that often is enough
+	_timeSinceMarkedInUse += a_timestep;
+	if (_timeSinceMarkedInUse < Settings::fAnimationEvictionCheckInterval) {
+		return;
+	}
+
+	_timeSinceMarkedInUse = 0.f;
+
+	auto& animationLoader = AnimationLoader::GetSingleton();
+	animationLoader.MarkUsed(_character, _clipGenerator->animationBindingIndex);
+	for (const auto& blendingClip : _blendingClipGenerators) {
+		animationLoader.MarkUsed(_character, blendingClip->clipGenerator.animationBindingIndex);
+	}
+}
+
+void ActiveClip::PrefetchLikelyReplacements() const
+{
+	auto& animationLoader = AnimationLoader::GetSingleton();
+
+	// the next sequential variant of whatever is playing or about to play
+	const auto replacementAnimation = HasQueuedReplacement() ? _queuedReplacement->replacementAnimation : _currentReplacementAnimation;
+	const auto variant = HasQueuedReplacement() ? _queuedReplacement->variant : _currentVariant;
+	if (replacementAnimation && variant && replacementAnimation->HasVariants()) {
+		if (const auto nextVariant = replacementAnimation->GetVariants().GetLikelyNextVariant(variant)) {
+			animationLoader.RequestAnimation(_character, nextVariant->GetIndex());
 		}
+	}
 
-		return false;
-	};
+	// other replacements of the same animation that could take over on interrupt, loop or echo
+	if (_replacements && _refr) {
+		uint32_t prefetchCount = 0;
+		_replacements->ForEachReplacementAnimation([&](ReplacementAnimation* a_replacementAnimation) {
+			// the variant that will play can't be predicted
+			if (prefetchCount >= Settings::uLazyLoadPrefetchCount || a_replacementAnimation == replacementAnimation || a_replacementAnimation->HasVariants() || a_replacementAnimation->IsDisabled()) {
+				return;
+			}
 
-	if (_blendingClipGenerators.size() == 1) {
-		const auto& blendingClip = _blendingClipGenerators.front();
-		return getTracks(blendingClip, a_outBlendedTracks);
+			if (a_replacementAnimation->GetConditionSet()->EvaluateActorInvariant(_refr, a_replacementAnimation->GetParentSubMod())) {
+				Variant* dummy = nullptr;
+				animationLoader.RequestAnimation(_character, a_replacementAnimation->GetIndex(_refr, dummy));
+				++prefetchCount;
+			}
+		});
 	}
+}
 
-	// get tracks from the first blending clip
-	auto it = _blendingClipGenerators.begin();
-	const auto& firstClip = *it;
-	float blendWeight = firstClip->GetBlendWeight();
-	if (!getTracks(*it, a_outBlendedTracks)) {
+bool ActiveClip::SampleBlendingPoses(uint32_t a_maxTracks)
+{
+	if (_blendingClipGenerators.empty()) {
 		return false;
 	}
-	++it;
 
-	// blend with the rest
-	while (it != _blendingClipGenerators.end()) {
-		const auto& blendingClip = *it;
-		std::vector<RE::hkQsTransform> sampledTransformTracks{};
-		if (getTracks(blendingClip, sampledTransformTracks)) {
-			const float lerpAmount = std::clamp(Utils::InterpEaseInOut(0.f, 1.f, blendWeight, 2), 0.f, 1.f);
+	_blendPoses.clear();
+	_blendTrackCounts.clear();
+	_blendAmounts.clear();
+
+	float blendWeight = 1.f;
+	for (const auto& blendingClip : _blendingClipGenerators) {
+		const auto binding = blendingClip->clipGenerator.animationControl->binding;
+		if (!binding || !binding->animation) {
+			// the oldest clip decides which tracks get blended, so there's nothing to blend without it
+			if (_blendPoses.empty()) {
+				return false;
+			}
+			continue;
+		}
+
+		const auto& blendFromAnimation = binding->animation;
+
+		// the tracks are ordered from the root outwards, so a partial sample only loses the small details
+		const uint32_t numTracks = std::min(static_cast<uint32_t>(blendFromAnimation->numberOfTransformTracks), a_maxTracks);
+
+		// the buffer keeps its capacity between frames, so this only allocates on the first sample
+		auto& sampledTracks = blendingClip->sampledTracks;
+		sampledTracks.resize(numTracks);
 
-			auto numBlend = std::min(a_outBlendedTracks.size(), static_cast<size_t>(blendingClip->clipGenerator.animationControl->binding->animation->numberOfTransformTracks));
-			hkbBlendPoses(numBlend, sampledTransformTracks.data(), a_outBlendedTracks.data(), lerpAmount, a_outBlendedTracks.data());
+		// float tracks aren't blended, so don't sample them at all
+		blendFromAnimation->SamplePartialTracks(blendingClip->clipGenerator.localTime, numTracks, sampledTracks.data(), 0, nullptr, nullptr);
 
-			blendWeight = blendingClip->GetBlendWeight();
+		if (!_blendPoses.empty()) {
+			_blendAmounts.emplace_back(std::clamp(Utils::InterpEaseInOut(0.f, 1.f, blendWeight, 2), 0.f, 1.f));
 		}
-		++it;
+		_blendPoses.emplace_back(reinterpret_cast<const float*>(sampledTracks.data()));
+		_blendTrackCounts.emplace_back(static_cast<uint32_t>(sampledTracks.size()));
+
+		blendWeight = blendingClip->GetBlendWeight();
 	}
 
+	// the result is blended over the output pose with the weight of the newest clip
+	_blendAmounts.emplace_back(std::clamp(Utils::InterpEaseInOut(0.f, 1.f, GetBlendWeight(), 2), 0.f, 1.f));
+
 	return true;
 }
 
+ActiveClip::BlendLOD ActiveClip::GetBlendLOD() const
+{
+	// never reduce the player's blends, in first person they can be outside the frustum while still being what's on screen
+	if (!Settings::bEnableBlendLOD || !_refr || _refr->IsPlayerRef()) {
+		return BlendLOD::kFull;
+	}
+
+	const auto camera = RE::Main::WorldRootCamera();
+	if (!camera) {
+		return BlendLOD::kFull;
+	}
+
+	const auto refrPosition = _refr->GetPosition();
+	const float distance = camera->world.translate.GetDistance(refrPosition);
+
+	if (distance > Settings::fBlendLODHardCutDistance) {
+		return BlendLOD::kHardCut;
+	}
+
+	if (distance > Settings::fBlendLODReducedDistance || !RE::NiCamera::PointInFrustum(refrPosition, camera, _refr->GetHeight())) {
+		return BlendLOD::kReduced;
+	}
+
+	return BlendLOD::kFull;
+}
+
 float ActiveClip::GetBlendWeight() const
 {
 	if (_blendingClipGenerators.empty()) {
@@ -42,6 +42,13 @@ public:
 		bool bReplaceAtTrueEndOfLoop = false;
 	};
 
+	enum class BlendLOD : uint8_t
+	{
+		kFull,
+		kReduced,  // far away or off screen, only the first tracks are blended
+		kHardCut   // very far away, no blending at all
+	};
+
 	struct BlendingClip
 	{
 		BlendingClip(RE::hkbClipGenerator* a_clipGenerator, float a_blendDuration) :
@@ -54,6 +61,7 @@ public:
 		FakeClipGenerator clipGenerator;
 		float blendDuration = 0.f;
 		float blendElapsedTime = 0.f;
+		std::vector<RE::hkQsTransform> sampledTracks{};
 	};
 
 	std::shared_ptr<ActiveClip> getptr()
@@ -91,6 +99,8 @@ public:
 	[[nodiscard]] RE::hkbCharacter* GetCharacter() const { return _character; }
 	[[nodiscard]] RE::hkbBehaviorGraph* GetBehaviorGraph() const { return _behaviorGraph; }
 	[[nodiscard]] RE::TESObjectREFR* GetRefr() const { return _refr; }
+	[[nodiscard]] RE::ObjectRefHandle GetRefHandle() const { return _refHandle; }
+	[[nodiscard]] uint32_t GetClipNameID() const { return _clipNameID; }
 	[[nodiscard]] bool IsSynchronizedClip() const { return _parentSynchronizedClipGenerator != nullptr; }
 	[[nodiscard]] RE::BSSynchronizedClipGenerator* GetParentSynchronizedClipGenerator() const { return _parentSynchronizedClipGenerator; }
 	[[nodiscard]] bool HasRemovedNonAnnotationTriggers() const { return _bRemovedNonAnnotationTriggers; }
@@ -120,12 +130,17 @@ public:
 
 	bool IsInLoopSequence();
 
-	StateDataContainer<const Conditions::ICondition*> conditionStateData;
+	StateDataContainer<const Conditions::ICondition*> conditionStateData{ this };
 
 protected:
 	bool OnLoopOrEcho(RE::hkbClipGenerator* a_clipGenerator, bool a_bIsEcho, float a_echoDuration = 0.f);
 	void RemoveNonAnnotationTriggersFromClipTriggerArray(RE::hkRefPtr<RE::hkbClipTriggerArray>& a_clipTriggerArray);
-	bool GetBlendedTracks(std::vector<RE::hkQsTransform>& a_outBlendedTracks);
+	bool ShouldEvaluateInterrupt(float a_timestep);
+	bool IsQueuedReplacementLoaded(float a_timestep);
+	void MarkAnimationsInUse(float a_timestep);
+	void PrefetchLikelyReplacements() const;
+	bool SampleBlendingPoses(uint32_t a_maxTracks);
+	[[nodiscard]] BlendLOD GetBlendLOD() const;
 	float GetBlendWeight() const;
 
 	AnimationReplacements* _replacements = nullptr;
@@ -137,6 +152,8 @@ protected:
 	RE::hkbCharacter* _character;
 	RE::hkbBehaviorGraph* _behaviorGraph;
 	RE::TESObjectREFR* _refr;
+	RE::ObjectRefHandle _refHandle;
+	const uint32_t _clipNameID;
 
 	const uint16_t _originalIndex;
 	const RE::hkbClipGenerator::PlaybackMode _originalMode;
@@ -153,7 +170,20 @@ protected:
 	bool _bTransitioning = false;
 	RE::BSSynchronizedClipGenerator* _parentSynchronizedClipGenerator = nullptr;
 
+	// interrupt check throttling
+	float _timeSinceInterruptEvaluation = 0.f;
+	uint64_t _interruptFactGeneration = 0;
+
+	// lazy loading
+	float _lazyLoadWaitTime = 0.f;
+	float _timeSinceMarkedInUse = 0.f;
+
 	// interruptible anim blending
 	float _lastGameTime = 0.f;
 	std::deque<std::unique_ptr<BlendingClip>> _blendingClipGenerators{};
+	BlendLOD _blendLOD = BlendLOD::kFull;
+	// filled by SampleBlendingPoses, reused between frames
+	std::vector<const float*> _blendPoses{};
+	std::vector<uint32_t> _blendTrackCounts{};
+	std::vector<float> _blendAmounts{};
 };
@@ -226,7 +226,7 @@ void ActiveSynchronizedAnimation::Initialize()
 				if (replacementAnimation) {
 					// handle variants
 					if (!_variantRandomWeight && replacementAnimation->HasVariants()) {
-						_variantRandomWeight = Utils::GetRandomFloat(0.f, 1.f);  // saving the random value will ensure we get the same variant for all involved clips
+						_variantRandomWeight = Utils::GetRandomFloat(0.f, 1.f, sourceRefHandle.get().get(), replacementAnimation->GetParentSubMod());  // saving the random value will ensure we get the same variant for all involved clips
 						replacementAnimation->GetIndex(variant, *_variantRandomWeight);
 					}
 				}
@@ -52,11 +52,7 @@ bool AnimationEventLogEntry::MatchesRegex(const std::regex& a_regex) const
 
 RE::BSEventNotifyControl AnimationEventLog::ProcessEvent(const RE::BSAnimationGraphEvent* a_event, RE::BSTEventSource<RE::BSAnimationGraphEvent>*)
 {
-	WriteLocker locker(_logLock);
-	_log.emplace_back(a_event);
-	_bHasNewEvent = true;
-
-	RefreshFilterInternal();
+	AddLogEntry(AnimationEventLogEntry(a_event));
 
 	return RE::BSEventNotifyControl::kContinue;
 }
@@ -65,11 +61,7 @@ void AnimationEventLog::TryAddEvent(RE::IAnimationGraphManagerHolder* a_holder,
 {
 	const auto holder = SKSE::stl::adjust_pointer<RE::TESObjectREFR>(a_holder, -0x38);
 	if (GetLogNotifies(holder->GetHandle())) {
-		WriteLocker locker(_logLock);
-		_log.emplace_back(holder, a_eventName, a_eventTriggeredTransition);
-		_bHasNewEvent = true;
-
-		RefreshFilterInternal();
+		AddLogEntry(AnimationEventLogEntry(holder, a_eventName, a_eventTriggeredTransition));
 	}
 }
 
@@ -92,12 +84,12 @@ void AnimationEventLog::ForEachLogEntry(const std::function<void(AnimationEventL
 	ReadLocker locker(_logLock);
 
 	if (a_bReverse) {
-		for (auto& logEntry : _filteredLog) {
-			a_func(logEntry);
+		for (const auto sequence : _filteredLog) {
+			a_func(GetLogEntry(sequence));
 		}
 	} else {
 		for (auto it = _filteredLog.rbegin(); it != _filteredLog.rend(); ++it) {
-			a_func(*it);
+			a_func(GetLogEntry(*it));
 		}
 	}
 }
@@ -113,7 +105,7 @@ void AnimationEventLog::ForEachLogEntry(const std::function<void(AnimationEventL
 		std::advance(end_it, a_clipperDisplayEnd);
 
 		for (auto it = start_it; it != end_it; ++it) {
-			a_func(*it);
+			a_func(GetLogEntry(*it));
 		}
 	} else {
 		auto start_it = _filteredLog.rbegin();
@@ -122,7 +114,7 @@ void AnimationEventLog::ForEachLogEntry(const std::function<void(AnimationEventL
 		std::advance(end_it, a_clipperDisplayEnd);
 
 		for (auto it = start_it; it != end_it; ++it) {
-			a_func(*it);
+			a_func(GetLogEntry(*it));
 		}
 	}
 }
@@ -132,6 +124,7 @@ void AnimationEventLog::ClearLog()
 	WriteLocker locker(_logLock);
 
 	_log.clear();
+	_nextSequence = 0;
 	_lastEventTimestamp = 0;
 
 	_filteredLog.clear();
@@ -247,21 +240,50 @@ void AnimationEventLog::RefreshFilter()
 	RefreshFilterInternal();
 }
 
+void AnimationEventLog::AddLogEntry(AnimationEventLogEntry&& a_entry)
+{
+	WriteLocker locker(_logLock);
+
+	const uint64_t sequence = _nextSequence++;
+	if (_log.size() < Settings::uAnimationEventLogCapacity) {
+		_log.reserve(Settings::uAnimationEventLogCapacity);
+		_log.emplace_back(std::move(a_entry));
+	} else {
+		// the log is full, overwrite the oldest entry and drop it from the filtered view
+		const uint64_t oldestSequence = sequence - Settings::uAnimationEventLogCapacity;
+		while (!_filteredLog.empty() && _filteredLog.front() <= oldestSequence) {
+			_filteredLog.pop_front();
+		}
+		_log[sequence % Settings::uAnimationEventLogCapacity] = std::move(a_entry);
+	}
+
+	if (MatchesFilter(*GetLogEntry(sequence))) {
+		_filteredLog.emplace_back(sequence);
+	}
+
+	_bHasNewEvent = true;
+}
+
 void AnimationEventLog::RefreshFilterInternal()
 {
-	bool bDoFilter = !filter.empty();
-	// construct regex from the filter string
-	std::regex filterRegex;
-	try {
-		filterRegex = std::regex(filter, std::regex::icase);
-	} catch (const std::regex_error&) {
-		bDoFilter = false;
+	// construct regex from the filter string, only done when the filter changes
+	_filterRegex.reset();
+	if (!filter.empty()) {
+		try {
+			_filterRegex = std::regex(filter, std::regex::icase);
+		} catch (const std::regex_error&) {}
 	}
 
 	_filteredLog.clear();
-	for (auto& entry : _log) {
-		if (!bDoFilter || entry.MatchesRegex(filterRegex)) {
-			_filteredLog.emplace_back(&entry);
+	const uint64_t oldestSequence = _nextSequence - _log.size();
+	for (uint64_t sequence = oldestSequence; sequence < _nextSequence; ++sequence) {
+		if (MatchesFilter(*GetLogEntry(sequence))) {
+			_filteredLog.emplace_back(sequence);
 		}
 	}
 }
+
+bool AnimationEventLog::MatchesFilter(const AnimationEventLogEntry& a_entry) const
+{
+	return !_filterRegex || a_entry.MatchesRegex(*_filterRegex);
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Settings.h"
+
 struct AnimationEventLogEntry
 {
 	AnimationEventLogEntry(const RE::BSAnimationGraphEvent* a_event);
@@ -71,11 +73,18 @@ private:
 	AnimationEventLog& operator=(const AnimationEventLog&) = delete;
 	AnimationEventLog& operator=(AnimationEventLog&&) = delete;
 
+	void AddLogEntry(AnimationEventLogEntry&& a_entry);
 	void RefreshFilterInternal();
+	[[nodiscard]] bool MatchesFilter(const AnimationEventLogEntry& a_entry) const;
+	[[nodiscard]] AnimationEventLogEntry* GetLogEntry(uint64_t a_sequence) { return &_log[a_sequence % Settings::uAnimationEventLogCapacity]; }
 
 	mutable SharedLock _logLock;
+	// ring buffer, once full the oldest entry gets overwritten. entries are identified by their sequence number, the slot is the sequence number modulo capacity
 	std::vector<AnimationEventLogEntry> _log = {};
-	std::vector<AnimationEventLogEntry*> _filteredLog = {};
+	uint64_t _nextSequence = 0;
+	// sequence numbers of the entries that match the filter, oldest first
+	std::deque<uint64_t> _filteredLog = {};
+	std::optional<std::regex> _filterRegex = std::nullopt;
 
 	mutable SharedLock _eventSourcesLock;
 	std::map<RE::ObjectRefHandle, EventSourceData> _eventSources = {};
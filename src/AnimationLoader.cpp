@@ -0,0 +1,257 @@
+#include "AnimationLoader.h"
+
+#include "Offsets.h"
+#include "OpenAnimationReplacer.h"
+#include "ReplacerMods.h"
+#include "Settings.h"
+
+void AnimationLoader::SchedulePreload(RE::BShkbAnimationGraph* a_graph, ReplacerProjectData* a_projectData)
+{
+	if (!a_graph || !a_projectData || a_projectData->animationsToQueue.empty()) {
+		return;
+	}
+
+	RE::TESObjectREFR* refr = a_graph->holder;
+	const bool bIsPlayer = refr && refr->IsPlayerRef();
+
+	std::unordered_set<uint16_t> pendingIndices(a_projectData->animationsToQueue.begin(), a_projectData->animationsToQueue.end());
+	std::array<std::vector<uint16_t>, static_cast<size_t>(Priority::kTotal)> prioritizedIndices;
+
+	auto schedule = [&](uint16_t a_index, Priority a_priority) {
+		if (pendingIndices.erase(a_index)) {
+			prioritizedIndices[static_cast<size_t>(a_priority)].emplace_back(a_index);
+		}
+	};
+
+	for (const auto& animationReplacements : a_projectData->originalIndexToAnimationReplacementsMap | std::views::values) {
+		animationReplacements->ForEachReplacementAnimation([&](const ReplacementAnimation* a_replacementAnimation) {
+			const bool bMatches = refr && a_replacementAnimation->GetConditionSet()->EvaluateActorInvariant(refr, a_replacementAnimation->GetParentSubMod());
+
+			Priority priority;
+			if (bMatches) {
+				priority = bIsPlayer ? Priority::kMatchedPlayer : Priority::kMatched;
+			} else {
+				priority = bIsPlayer ? Priority::kUnmatchedPlayer : Priority::kUnmatched;
+			}
+
+			if (a_replacementAnimation->HasVariants()) {
+				a_replacementAnimation->ForEachVariant([&](const Variant& a_variant) {
+					schedule(a_variant.GetIndex(), priority);
+					return RE::BSVisit::BSVisitControl::kContinue;
+				});
+			} else {
+				Variant* dummy = nullptr;
+				schedule(a_replacementAnimation->GetIndex(refr, dummy), priority);
+			}
+		});
+	}
+
+	// anything that couldn't be matched to a replacement animation is still loaded, just last
+	for (const auto& animIndex : a_projectData->animationsToQueue) {
+		schedule(animIndex, Priority::kUnmatched);
+	}
+
+	a_projectData->animationsToQueue.clear();
+
+	WriteLocker locker(_lock);
+
+	for (size_t i = 0; i < prioritizedIndices.size(); ++i) {
+		if (!prioritizedIndices[i].empty()) {
+			_scheduledCount += prioritizedIndices[i].size();
+			_batches[i].emplace_back(Batch{ RE::BSTSmartPointer<RE::BShkbAnimationGraph>(a_graph), std::move(prioritizedIndices[i]) });
+		}
+	}
+}
+
+void AnimationLoader::Update()
+{
+	if (Settings::bEnableAnimationEviction) {
+		_timeSinceEvictionCheck += g_deltaTime;
+		if (_timeSinceEvictionCheck >= Settings::fAnimationEvictionCheckInterval) {
+			_timeSinceEvictionCheck = 0.f;
+			EvictIdleAnimations();
+		}
+	}
+
+	WriteLocker locker(_lock);
+
+	if (_scheduledCount == 0) {
+		return;
+	}
+
+	uint32_t budget = Settings::uPreloadBudgetPerFrame > 0 ? Settings::uPreloadBudgetPerFrame : std::numeric_limits<uint32_t>::max();
+
+	OpenAnimationReplacer::bIsPreLoading = true;
+
+	for (auto& batches : std::ranges::reverse_view(_batches)) {
+		while (budget > 0 && !batches.empty()) {
+			auto& batch = batches.front();
+			const auto character = &batch.graph->characterInstance;
+			const auto stringData = Utils::GetStringDataFromHkbCharacter(character);
+			while (budget > 0 && batch.nextIndex < batch.animationIndices.size()) {
+				const uint16_t animIndex = batch.animationIndices[batch.nextIndex++];
+				if (stringData && Hold(batch.graph.get(), stringData, animIndex)) {
+					OpenAnimationReplacer::LoadAnimation(character, animIndex);
+				}
+				--_scheduledCount;
+				--budget;
+			}
+
+			if (batch.nextIndex == batch.animationIndices.size()) {
+				batches.pop_front();
+			}
+		}
+	}
+
+	OpenAnimationReplacer::bIsPreLoading = false;
+}
+
+size_t AnimationLoader::GetScheduledCount() const
+{
+	ReadLocker locker(_lock);
+	return _scheduledCount;
+}
+
+bool AnimationLoader::RequestAnimation(RE::hkbCharacter* a_character, uint16_t a_animationIndex)
+{
+	if (OpenAnimationReplacer::IsAnimationLoaded(a_character, a_animationIndex)) {
+		return true;
+	}
+
+	const auto stringData = Utils::GetStringDataFromHkbCharacter(a_character);
+	if (!stringData) {
+		return false;
+	}
+
+	// the animation stays unloaded for a few frames after it's requested, don't take the write lock again while it's loading
+	{
+		ReadLocker locker(_lock);
+		if (_heldAnimations.contains({ stringData, a_animationIndex })) {
+			return false;
+		}
+	}
+
+	bool bHeld;
+	{
+		WriteLocker locker(_lock);
+		bHeld = Hold(SKSE::stl::adjust_pointer<RE::BShkbAnimationGraph>(a_character, -0xC0), stringData, a_animationIndex);
+	}
+
+	if (bHeld) {
+		OpenAnimationReplacer::LoadAnimation(a_character, a_animationIndex);
+	}
+
+	return false;
+}
+
+void AnimationLoader::MarkUsed(RE::hkbCharacter* a_character, uint16_t a_animationIndex)
+{
+	const auto stringData = Utils::GetStringDataFromHkbCharacter(a_character);
+	if (!stringData) {
+		return;
+	}
+
+	// the project's graph was already kept when the animation was held, so only the use time needs to be written here
+	ReadLocker locker(_lock);
+
+	if (const auto it = _heldAnimations.find({ stringData, a_animationIndex }); it != _heldAnimations.end()) {
+		it->second.lastUseTime.store(OpenAnimationReplacer::gameTimeCounter, std::memory_order_relaxed);
+	}
+}
+
+size_t AnimationLoader::GetHeldCount() const
+{
+	ReadLocker locker(_lock);
+	return _heldAnimations.size();
+}
+
+uint64_t AnimationLoader::GetHeldBytes() const
+{
+	ReadLocker locker(_lock);
+	return _heldBytes;
+}
+
+bool AnimationLoader::Hold(RE::BShkbAnimationGraph* a_graph, RE::hkbCharacterStringData* a_stringData, uint16_t a_animationIndex)
+{
+	// expects _lock to be write locked
+	const auto [it, bInserted] = _heldAnimations.try_emplace({ a_stringData, a_animationIndex }, OpenAnimationReplacer::gameTimeCounter);
+	if (bInserted) {
+		if (const auto projectData = OpenAnimationReplacer::GetSingleton().GetReplacerProjectData(a_stringData)) {
+			it->second.size = projectData->GetAnimationFileSize(a_animationIndex);
+			_heldBytes += it->second.size;
+		}
+		SetProjectGraph(a_graph, a_stringData);
+	}
+
+	return bInserted;
+}
+
+void AnimationLoader::SetProjectGraph(RE::BShkbAnimationGraph* a_graph, RE::hkbCharacterStringData* a_stringData)
+{
+	// expects _lock to be write locked. Any graph of the project works, so the first one is kept
+	if (a_graph) {
+		_projectGraphs.try_emplace(a_stringData, a_graph);
+	}
+}
+
+void AnimationLoader::EvictIdleAnimations()
+{
+	const uint64_t budget = static_cast<uint64_t>(Settings::uAnimationEvictionBudget) << 20;
+	if (GetHeldBytes() <= budget) {
+		return;
+	}
+
+	// animations that are playing or blending out get their use time refreshed from the behavior graph update, so only the held animations are looked at here
+	const float currentTime = OpenAnimationReplacer::gameTimeCounter;
+	std::vector<std::pair<uint16_t, RE::BSTSmartPointer<RE::BShkbAnimationGraph>>> animationsToEvict;
+
+	{
+		WriteLocker locker(_lock);
+
+		std::vector<std::pair<float, AnimationKey>> candidates;
+		for (const auto& [key, heldAnimation] : _heldAnimations) {
+			const float lastUseTime = heldAnimation.lastUseTime.load(std::memory_order_relaxed);
+			if (currentTime - lastUseTime > Settings::fAnimationEvictionIdleTime && _projectGraphs.contains(key.first)) {
+				candidates.emplace_back(lastUseTime, key);
+			}
+		}
+
+		// least recently used first
+		std::ranges::sort(candidates, {}, &std::pair<float, AnimationKey>::first);
+
+		for (const auto& key : candidates | std::views::values) {
+			if (_heldBytes <= budget) {
+				break;
+			}
+
+			// synchronized clips are replaced when activated and can't wait for a file to load, so their replacements stay loaded
+			const auto projectData = OpenAnimationReplacer::GetSingleton().GetReplacerProjectData(key.first);
+			if (!projectData || projectData->IsSynchronizedReplacementIndex(key.second)) {
+				continue;
+			}
+
+			const auto it = _heldAnimations.find(key);
+			_heldBytes -= it->second.size;
+			_heldAnimations.erase(it);
+			animationsToEvict.emplace_back(key.second, _projectGraphs[key.first]);
+		}
+
+		if (!animationsToEvict.empty()) {
+			// don't keep graphs alive for projects that have nothing held anymore
+			std::unordered_set<RE::hkbCharacterStringData*> heldProjects;
+			for (const auto& key : _heldAnimations | std::views::keys) {
+				heldProjects.emplace(key.first);
+			}
+			std::erase_if(_projectGraphs, [&](const auto& a_pair) { return !heldProjects.contains(a_pair.first); });
+		}
+	}
+
+	for (const auto& [animationIndex, graph] : animationsToEvict) {
+		OpenAnimationReplacer::UnloadAnimation(&graph->characterInstance, animationIndex);
+	}
+
+	if (!animationsToEvict.empty()) {
+		_evictedCount += animationsToEvict.size();
+		logger::debug("evicted {} idle replacement animations", animationsToEvict.size());
+	}
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "Settings.h"
+
+class ReplacerProjectData;
+
+// schedules replacement animations to be loaded through the game's animation file manager
+// instead of queueing all of a project's replacements at once when it loads, they're submitted in priority order, a limited amount per frame, so the game's own queue stays responsive
+// with preloading disabled, replacements are instead requested on demand the first time they're about to play
+// also keeps track of the replacements it loaded and when they were last used, so idle ones can be unloaded again when over the memory budget
+class AnimationLoader
+{
+public:
+	// replacements whose actor invariant conditions (e.g. race, sex) match the actor that loaded the project go first, as they're the ones most likely to be needed soon
+	enum class Priority : uint8_t
+	{
+		kUnmatched,
+		kUnmatchedPlayer,
+		kMatched,
+		kMatchedPlayer,
+
+		kTotal
+	};
+
+	static AnimationLoader& GetSingleton()
+	{
+		static AnimationLoader singleton;
+		return singleton;
+	}
+
+	// takes the project's pending replacement animations and schedules them to be preloaded
+	void SchedulePreload(RE::BShkbAnimationGraph* a_graph, ReplacerProjectData* a_projectData);
+
+	// called every frame, submits the scheduled animations with the highest priority to the game, up to the per-frame budget
+	void Update();
+
+	[[nodiscard]] size_t GetScheduledCount() const;
+
+	// lazy loading - queues the animation if it wasn't requested before, returns whether it's loaded and ready to play
+	bool RequestAnimation(RE::hkbCharacter* a_character, uint16_t a_animationIndex);
+	// replacements have to be loaded on demand if they can get unloaded
+	[[nodiscard]] static bool ShouldLoadOnDemand() { return Settings::bDisablePreloading || Settings::bEnableAnimationEviction; }
+
+	// refreshes the last use time of the animation, called from the behavior graph update while it's playing or blending out
+	void MarkUsed(RE::hkbCharacter* a_character, uint16_t a_animationIndex);
+
+	[[nodiscard]] size_t GetHeldCount() const;
+	[[nodiscard]] uint64_t GetHeldBytes() const;
+	[[nodiscard]] size_t GetEvictedCount() const { return _evictedCount; }
+
+private:
+	AnimationLoader() = default;
+	AnimationLoader(const AnimationLoader&) = delete;
+	AnimationLoader(AnimationLoader&&) = delete;
+	~AnimationLoader() = default;
+
+	AnimationLoader& operator=(const AnimationLoader&) = delete;
+	AnimationLoader& operator=(AnimationLoader&&) = delete;
+
+	// animations scheduled by a single graph, the graph is kept alive until all of them are submitted
+	struct Batch
+	{
+		RE::BSTSmartPointer<RE::BShkbAnimationGraph> graph;
+		std::vector<uint16_t> animationIndices;
+		size_t nextIndex = 0;
+	};
+
+	using AnimationKey = std::pair<RE::hkbCharacterStringData*, uint16_t>;
+
+	// the last use time is refreshed from graph threads under a read lock, so it's atomic and the map is only written to under the write lock
+	struct HeldAnimation
+	{
+		HeldAnimation(float a_lastUseTime) :
+			lastUseTime(a_lastUseTime) {}
+
+		std::atomic<float> lastUseTime;
+		uint32_t size = 0;
+	};
+
+	bool Hold(RE::BShkbAnimationGraph* a_graph, RE::hkbCharacterStringData* a_stringData, uint16_t a_animationIndex);
+	void SetProjectGraph(RE::BShkbAnimationGraph* a_graph, RE::hkbCharacterStringData* a_stringData);
+	void EvictIdleAnimations();
+
+	mutable SharedLock _lock;
+	std::array<std::deque<Batch>, static_cast<size_t>(Priority::kTotal)> _batches;
+	size_t _scheduledCount = 0;
+
+	// every animation queued by us, each one is only queued once as every queue call holds a reference in the animation file manager until it's unloaded
+	std::unordered_map<AnimationKey, HeldAnimation, boost::hash<AnimationKey>> _heldAnimations;
+	uint64_t _heldBytes = 0;
+	// a graph of each project with held animations, kept alive so the evictor can unload through it without looking at active clips
+	std::unordered_map<RE::hkbCharacterStringData*, RE::BSTSmartPointer<RE::BShkbAnimationGraph>> _projectGraphs;
+	std::atomic<size_t> _evictedCount = 0;
+	float _timeSinceEvictionCheck = 0.f;
+};
@@ -7,17 +7,17 @@
 #include "UI/UIManager.h"
 #include "Utils.h"
 
-AnimationLogEntry::AnimationLogEntry(Event a_event, ActiveClip* a_activeClip, RE::hkbCharacter* a_character) :
-	event(a_event)
+AnimationLogEntry::AnimationLogEntry(const AnimationLogRecord& a_record) :
+	event(a_record.event)
 {
-	const auto replacementAnimation = a_activeClip->GetReplacementAnimation();
+	const auto replacementAnimation = a_record.replacementAnimation;
 	bOriginal = replacementAnimation == nullptr;
-	bInterruptible = a_activeClip->IsInterruptible();
-	animationName = a_activeClip->GetClipGenerator()->animationName.data();
-	clipName = a_activeClip->GetClipGenerator()->name.data();
+	bInterruptible = a_record.bInterruptible;
+	animationName = Utils::GetOriginalAnimationName(a_record.stringData, a_record.originalIndex);
+	clipName = OpenAnimationReplacer::GetSingleton().GetClipName(a_record.clipNameID);
 
-	if (const auto stringData = Utils::GetStringDataFromHkbCharacter(a_character)) {
-		projectName = stringData->name.data();
+	if (a_record.stringData) {
+		projectName = a_record.stringData->name.data();
 	}
 
 	if (replacementAnimation) {
@@ -42,11 +42,11 @@ AnimationLogEntry::AnimationLogEntry(Event a_event, ActiveClip* a_activeClip, RE
 		// variants
 		bVariant = replacementAnimation->HasVariants();
 		if (bVariant) {
-			variantFilename = replacementAnimation->GetVariantFilename(a_activeClip->GetCurrentIndex());
+			variantFilename = replacementAnimation->GetVariantFilename(a_record.currentIndex);
 		}
 	} else {
-		if (const auto stringData = Utils::GetStringDataFromHkbCharacter(a_character)) {
-			animPath = Utils::GetOriginalAnimationName(stringData, a_activeClip->GetOriginalIndex());
+		if (a_record.stringData) {
+			animPath = Utils::GetOriginalAnimationName(a_record.stringData, a_record.originalIndex);
 
 			// shorten the path by removing the first directory
 			const auto slashCount = std::ranges::count(animPath, '\\');
@@ -195,35 +195,51 @@ bool AnimationLogEntry::MatchesEvent(const std::regex& a_regex) const
 
 void AnimationLog::LogAnimation(AnimationLogEntry::Event a_event, ActiveClip* a_activeClip, RE::hkbCharacter* a_character)
 {
+	const AnimationLogRecord record{
+		.generation = _generation.load(std::memory_order_relaxed),
+		.event = a_event,
+		.bInterruptible = a_activeClip->IsInterruptible(),
+		.originalIndex = a_activeClip->GetOriginalIndex(),
+		.currentIndex = a_activeClip->GetCurrentIndex(),
+		.clipNameID = a_activeClip->GetClipNameID(),
+		.stringData = Utils::GetStringDataFromHkbCharacter(a_character),
+		.replacementAnimation = a_activeClip->GetReplacementAnimation()
+	};
+
+	// if the UI thread falls behind the record is dropped, the log is limited to a few entries anyway
+	_pendingEntries.TryPush(record);
+}
+
+void AnimationLog::ProcessPendingEntries()
+{
+	AnimationLogRecord record;
+	if (!_pendingEntries.TryPop(record)) {
+		return;
+	}
+
 	{
 		WriteLocker locker(_animationLogLock);
 
-		const AnimationLogEntry newEntry{ a_event, a_activeClip, a_character };
+		const uint32_t generation = _generation.load(std::memory_order_relaxed);
 
-		// does it match the filter string?
-		if (bool bDoFilter = !filter.empty()) {
-			std::regex filterRegex;
-			try {
-				filterRegex = std::regex(filter, std::regex::icase);
-			} catch (const std::regex_error&) {
-				bDoFilter = false;
+		do {
+			if (record.generation != generation) {
+				continue;
 			}
 
-			if (bDoFilter) {
-				if (!newEntry.MatchesRegex(filterRegex)) {
-					return;
-				}
+			const AnimationLogEntry newEntry{ record };
+
+			// does it match the filter string?
+			if (_filterRegex && !newEntry.MatchesRegex(*_filterRegex)) {
+				continue;
 			}
-		}
 
-		if (_animationLog.size() > 0 && _animationLog.front() == newEntry) {
-			auto& frontEntry = _animationLog.front();
-			if (frontEntry == newEntry) {
-				frontEntry.IncreaseCount();
+			if (!_animationLog.empty() && _animationLog.front() == newEntry) {
+				_animationLog.front().IncreaseCount();
+			} else {
+				_animationLog.emplace_front(newEntry);
 			}
-		} else {
-			_animationLog.emplace_front(newEntry);
-		}
+		} while (_pendingEntries.TryPop(record));
 	}
 
 	ClampLog();
@@ -256,6 +272,9 @@ void AnimationLog::ForEachAnimationLogEntry(const std::function<void(AnimationLo
 
 void AnimationLog::ClearAnimationLog()
 {
+	// discard anything that hasn't been processed yet
+	++_generation;
+
 	WriteLocker locker(_animationLogLock);
 
 	_animationLog.clear();
@@ -313,3 +332,13 @@ void AnimationLog::SetLogAnimations(bool a_enable)
 {
 	_bLogAnimations = a_enable;
 }
+
+void AnimationLog::RefreshFilter()
+{
+	_filterRegex.reset();
+	if (!filter.empty()) {
+		try {
+			_filterRegex = std::regex(filter, std::regex::icase);
+		} catch (const std::regex_error&) {}
+	}
+}
@@ -1,5 +1,10 @@
 #pragma once
 
+#include "MPSCRingBuffer.h"
+#include "Settings.h"
+
+struct AnimationLogRecord;
+
 struct AnimationLogEntry
 {
 	enum class Event : uint8_t
@@ -18,7 +23,7 @@ struct AnimationLogEntry
 		kPairedMismatch
 	};
 
-	AnimationLogEntry(Event a_event, class ActiveClip* a_activeClip, RE::hkbCharacter* a_character);
+	explicit AnimationLogEntry(const AnimationLogRecord& a_record);
 
 	[[nodiscard]] bool operator==(const AnimationLogEntry& a_rhs) const;
 	[[nodiscard]] bool operator!=(const AnimationLogEntry& a_rhs) const;
@@ -45,6 +50,20 @@ protected:
 	bool MatchesEvent(const std::regex& a_regex) const;
 };
 
+// what the clip hooks push to the log - just pointers and IDs, the strings are only resolved on the UI thread
+// everything referenced here lives as long as the game (interned clip names, project string data, replacement animations)
+struct AnimationLogRecord
+{
+	uint32_t generation;
+	AnimationLogEntry::Event event;
+	bool bInterruptible;
+	uint16_t originalIndex;
+	uint16_t currentIndex;
+	uint32_t clipNameID;
+	RE::hkbCharacterStringData* stringData;
+	const class ReplacementAnimation* replacementAnimation;
+};
+
 class AnimationLog
 {
 public:
@@ -54,7 +73,10 @@ public:
 		return singleton;
 	}
 
-	void LogAnimation(AnimationLogEntry::Event a_event, ActiveClip* a_activeClip, RE::hkbCharacter* a_character);
+	// called from the behavior graph threads
+	void LogAnimation(AnimationLogEntry::Event a_event, class ActiveClip* a_activeClip, RE::hkbCharacter* a_character);
+	// called from the UI thread, turns the pending records into log entries
+	void ProcessPendingEntries();
 	void ClampLog();
 	[[nodiscard]] bool IsAnimationLogEmpty() const;
 	void ForEachAnimationLogEntry(const std::function<void(AnimationLogEntry&)>& a_func);
@@ -62,6 +84,7 @@ public:
 	[[nodiscard]] bool ShouldLogAnimations() const { return _bLogAnimations; }
 	[[nodiscard]] bool ShouldLogAnimationsForActiveClip(ActiveClip* a_activeClip, AnimationLogEntry::Event a_logEvent) const;
 	void SetLogAnimations(bool a_enable);
+	void RefreshFilter();
 
 	std::string filter = {};
 
@@ -77,4 +100,10 @@ private:
 	mutable SharedLock _animationLogLock;
 	std::deque<AnimationLogEntry> _animationLog = {};
 	bool _bLogAnimations = false;
+
+	MPSCRingBuffer<AnimationLogRecord, Settings::uAnimationLogQueueCapacity> _pendingEntries;
+	// the log can be cleared from any thread, pending records from before that are skipped when processed
+	std::atomic<uint32_t> _generation = 0;
+	// compiled once per filter change
+	std::optional<std::regex> _filterRegex = std::nullopt;
 };
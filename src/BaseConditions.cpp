@@ -63,19 +63,19 @@ namespace Conditions
 					case GraphVariableType::kFloat:
 						{
 							float outValue = 0.f;
-							a_refr->GetGraphVariableFloat(_graphVariableName.GetValue(), outValue);
+							a_refr->GetGraphVariableFloat(_graphVariableName.GetFixedValue(), outValue);
 							return outValue;
 						}
 					case GraphVariableType::kInt:
 						{
 							int32_t outValue = 0;
-							a_refr->GetGraphVariableInt(_graphVariableName.GetValue(), outValue);
+							a_refr->GetGraphVariableInt(_graphVariableName.GetFixedValue(), outValue);
 							return static_cast<float>(outValue);
 						}
 					case GraphVariableType::kBool:
 						{
 							bool outValue;
-							a_refr->GetGraphVariableBool(_graphVariableName.GetValue(), outValue);
+							a_refr->GetGraphVariableBool(_graphVariableName.GetFixedValue(), outValue);
 							return outValue;
 						}
 					}
@@ -503,6 +503,7 @@ namespace Conditions
 				flags |= ImGuiInputTextFlags_CharsNoBlank;
 			}
 			if (ImGui::InputTextWithHint("##Text", "Text...", &_text, flags)) {
+				_fixedText = _text;
 				bEdited = true;
 			}
 			ImGui::PopID();
@@ -516,6 +517,7 @@ namespace Conditions
 	void TextValue::Parse(const rapidjson::Value& a_value)
 	{
 		_text = (a_value.GetString());
+		_fixedText = _text;
 	}
 
 	rapidjson::Value TextValue::Serialize([[maybe_unused]] rapidjson::Document::AllocatorType& a_allocator) const
@@ -608,6 +610,24 @@ namespace Conditions
 		return std::ranges::any_of(_conditions, [&](auto& a_condition) { return !a_condition->IsValid(); });
 	}
 
+	bool ConditionSet::EvaluateActorInvariant(RE::TESObjectREFR* a_refr, SubMod* a_parentSubMod) const
+	{
+		ReadLocker locker(_lock);
+
+		// only the top level conditions are checked, anything that can change at runtime is treated as passing
+		return std::ranges::all_of(_conditions, [&](auto& a_condition) {
+			if (a_condition->IsDisabled() || a_condition->GetConditionType() == ConditionType::kCustom) {
+				return true;
+			}
+
+			if (!static_cast<const ConditionBase*>(a_condition.get())->IsActorInvariant()) {
+				return true;
+			}
+
+			return a_condition->Evaluate(a_refr, nullptr, a_parentSubMod);
+		});
+	}
+
 	RE::BSVisit::BSVisitControl ConditionSet::ForEachCondition(const std::function<RE::BSVisit::BSVisitControl(std::unique_ptr<ICondition>&)>& a_func)
 	{
 		using Result = RE::BSVisit::BSVisitControl;
@@ -1486,6 +1506,18 @@ namespace Conditions
 		return OpenAnimationReplacer::GetSingleton().AddConditionStateData(a_stateData, this, a_refr, a_clipGenerator, a_parentSubMod);
 	}
 
+	uint32_t ConditionStateComponent::GetConditionNameID() const
+	{
+		// the condition name can't change, so it's only interned once instead of building a string on every state data lookup
+		auto conditionNameID = _conditionNameID.load();
+		if (conditionNameID == 0) {
+			conditionNameID = OpenAnimationReplacer::GetSingleton().GetConditionNameID(GetParentCondition()->GetName().data());
+			_conditionNameID = conditionNameID;
+		}
+
+		return conditionNameID;
+	}
+
 	bool ConditionStateComponent::CanSelectScope() const
 	{
 		// check if there's more than one flag set
@@ -175,7 +175,13 @@ namespace Conditions
 	{
 	public:
 		[[nodiscard]] std::string_view GetValue() const { return _text; }
-		void SetValue(std::string_view a_text) { _text = a_text; }
+		[[nodiscard]] const RE::BSFixedString& GetFixedValue() const { return _fixedText; }
+
+		void SetValue(std::string_view a_text)
+		{
+			_text = a_text;
+			_fixedText = _text;
+		}
 
 		bool DisplayInUI(bool a_bEditable, float a_firstColumnWidthPercent);
 
@@ -187,6 +193,7 @@ namespace Conditions
 
 	protected:
 		std::string _text{};
+		RE::BSFixedString _fixedText{};  // interned copy of _text, so evaluating doesn't need a string pool lookup every time
 		bool _bAllowSpaces = true;
 	};
 
@@ -383,6 +390,44 @@ namespace Conditions
 		bool _bIsValid = false;
 	};
 
+	// case-insensitive editor ID -> keyword forms multimap, built once after data is loaded so resolving keyword literals doesn't scan the whole form array for every condition
+	template <Derived<RE::BGSKeyword> T>
+	class KeywordEditorIDMap
+	{
+	public:
+		static void Build()
+		{
+			WriteLocker locker(_lock);
+			_map.clear();
+
+			auto& keywords = RE::TESDataHandler::GetSingleton()->GetFormArray<T>();
+			_map.reserve(keywords.size());
+			for (auto& kywd : keywords) {
+				if (kywd && !kywd->formEditorID.empty()) {
+					_map.emplace(kywd->formEditorID.c_str(), kywd);
+				}
+			}
+
+			_bBuilt = true;
+		}
+
+		[[nodiscard]] static bool IsBuilt() { return _bBuilt; }
+
+		static void ForEachMatch(std::string_view a_editorID, const std::function<void(T*)>& a_func)
+		{
+			ReadLocker locker(_lock);
+			const auto [begin, end] = _map.equal_range(std::string(a_editorID));
+			for (auto it = begin; it != end; ++it) {
+				a_func(it->second);
+			}
+		}
+
+	private:
+		static inline SharedLock _lock;
+		static inline std::unordered_multimap<std::string, T*, CaseInsensitiveHash, CaseInsensitiveEqual> _map;
+		static inline std::atomic_bool _bBuilt = false;
+	};
+
 	template <Derived<RE::BGSKeyword> T>
 	class KeywordValue
 	{
@@ -393,7 +438,8 @@ namespace Conditions
 			_type(a_rhs._type),
 			_keywordForm(a_rhs._keywordForm),
 			_keywordLiteral(a_rhs._keywordLiteral),
-			_keywordFormsMatchingLiteral(a_rhs._keywordFormsMatchingLiteral) {}
+			_keywordFormsMatchingLiteral(a_rhs._keywordFormsMatchingLiteral),
+			_sortedKeywordFormIDs(a_rhs._sortedKeywordFormIDs) {}
 
 		KeywordValue& operator=(KeywordValue&& a_rhs) noexcept
 		{
@@ -401,6 +447,7 @@ namespace Conditions
 			_keywordLiteral = a_rhs._keywordLiteral;
 			_keywordForm = a_rhs._keywordForm;
 			_keywordFormsMatchingLiteral = a_rhs._keywordFormsMatchingLiteral;
+			_sortedKeywordFormIDs = a_rhs._sortedKeywordFormIDs;
 
 			return *this;
 		}
@@ -424,6 +471,19 @@ namespace Conditions
 
 		bool HasKeyword(const RE::BGSKeywordForm* a_keywordForm) const
 		{
+			if (_type == Type::kLiteral) {
+				// a literal can match multiple keyword forms, scan the form's keywords once and binary search them in the sorted IDs instead of scanning the form once per keyword
+				ReadLocker locker(_dataLock);
+				if (_sortedKeywordFormIDs.size() > 1) {
+					for (uint32_t i = 0; i < a_keywordForm->numKeywords; ++i) {
+						if (const auto keyword = a_keywordForm->keywords[i]; keyword && std::ranges::binary_search(_sortedKeywordFormIDs, keyword->GetFormID())) {
+							return true;
+						}
+					}
+					return false;
+				}
+			}
+
 			bool bFound = false;
 			ForEachKeyword([&](T* a_keyword) {
 				if (a_keywordForm->HasKeyword(a_keyword)) {
@@ -440,6 +500,7 @@ namespace Conditions
 		{
 			WriteLocker locker(_dataLock);
 			_keywordFormsMatchingLiteral.clear();
+			_sortedKeywordFormIDs.clear();
 
 			_type = Type::kForm;
 			_keywordForm.SetValue(a_keyword);
@@ -597,14 +658,25 @@ namespace Conditions
 			WriteLocker locker(_dataLock);
 			_keywordForm.SetValue(nullptr);
 			_keywordFormsMatchingLiteral.clear();
+			_sortedKeywordFormIDs.clear();
 			_type = Type::kLiteral;
 
-			auto& keywords = RE::TESDataHandler::GetSingleton()->GetFormArray<T>();
-			for (auto& kywd : keywords) {
-				if (kywd && kywd->formEditorID == std::string_view(_keywordLiteral)) {
-					_keywordFormsMatchingLiteral.emplace_back(kywd);
+			if (KeywordEditorIDMap<T>::IsBuilt()) {
+				KeywordEditorIDMap<T>::ForEachMatch(_keywordLiteral, [&](T* a_kywd) {
+					_keywordFormsMatchingLiteral.emplace_back(a_kywd);
+					_sortedKeywordFormIDs.emplace_back(a_kywd->GetFormID());
+				});
+			} else {
+				auto& keywords = RE::TESDataHandler::GetSingleton()->GetFormArray<T>();
+				for (auto& kywd : keywords) {
+					if (kywd && kywd->formEditorID == std::string_view(_keywordLiteral)) {
+						_keywordFormsMatchingLiteral.emplace_back(kywd);
+						_sortedKeywordFormIDs.emplace_back(kywd->GetFormID());
+					}
 				}
 			}
+
+			std::ranges::sort(_sortedKeywordFormIDs);
 		}
 
 		void ForEachKeyword(std::function<RE::BSContainer::ForEachResult(T*)> a_callback) const
@@ -641,6 +713,7 @@ namespace Conditions
 		std::string _keywordLiteral{};
 		mutable SharedLock _dataLock{};
 		std::vector<T*> _keywordFormsMatchingLiteral{};
+		std::vector<RE::FormID> _sortedKeywordFormIDs{};
 	};
 
 	class ConditionBase : public ICondition
@@ -678,6 +751,12 @@ namespace Conditions
 		[[nodiscard]] ConditionType GetConditionType() const override { return ConditionType::kNormal; }
 		[[nodiscard]] ICondition* GetWrappedCondition() const override { return nullptr; }
 
+		// whether the result only depends on things that (almost) never change for a given actor, like its base form or race. Used to prioritize preloading
+		[[nodiscard]] virtual bool IsActorInvariant() const { return false; }
+
+		// whether the state data this condition creates overrides IStateData::Update and has to be updated every frame
+		[[nodiscard]] virtual bool HasTickingStateData() const { return false; }
+
 		template <typename T>
 		T* AddComponent(std::string_view a_name, std::string_view a_description = ""sv)
 		{
@@ -727,6 +806,7 @@ namespace Conditions
 		bool IsDirty() const { return _bDirty; }
 		void SetDirty(bool a_bDirty) { _bDirty = a_bDirty; }
 		bool HasInvalidConditions() const;
+		bool EvaluateActorInvariant(RE::TESObjectREFR* a_refr, SubMod* a_parentSubMod) const;
 		RE::BSVisit::BSVisitControl ForEachCondition(const std::function<RE::BSVisit::BSVisitControl(std::unique_ptr<ICondition>&)>& a_func);
 		void AddCondition(std::unique_ptr<ICondition>& a_condition, bool a_bSetDirty = false);
 		void RemoveCondition(const std::unique_ptr<ICondition>& a_condition);
@@ -1058,6 +1138,8 @@ namespace Conditions
 		[[nodiscard]] IStateData* GetStateData(RE::TESObjectREFR* a_refr, RE::hkbClipGenerator* a_clipGenerator, void* a_parentSubMod) const override;
 		[[nodiscard]] IStateData* AddStateData(IStateData* a_stateData, RE::TESObjectREFR* a_refr, RE::hkbClipGenerator* a_clipGenerator, void* a_parentSubMod) override;
 
+		[[nodiscard]] uint32_t GetConditionNameID() const;
+
 		StateDataScope allowedScopes = StateDataScope::kLocal | StateDataScope::kSubMod;
 		StateDataScope scope = StateDataScope::kLocal;
 		bool bCanResetOnLoopOrEcho = true;
@@ -1115,6 +1197,8 @@ namespace Conditions
 
 	protected:
 		bool CanSelectScope() const;
+
+		mutable std::atomic<uint32_t> _conditionNameID = 0;
 	};
 
 	class ConditionPresetComponent : public IMultiConditionComponent
@@ -0,0 +1,314 @@
+#include "ConditionFactCache.h"
+
+#include "Settings.h"
+
+void ConditionFactCache::RegisterEventSinks()
+{
+	if (_bRegistered) {
+		return;
+	}
+
+	if (const auto scriptEventSourceHolder = RE::ScriptEventSourceHolder::GetSingleton()) {
+		scriptEventSourceHolder->AddEventSink<RE::TESEquipEvent>(this);
+		scriptEventSourceHolder->AddEventSink<RE::TESContainerChangedEvent>(this);
+		scriptEventSourceHolder->AddEventSink<RE::TESMagicEffectApplyEvent>(this);
+		scriptEventSourceHolder->AddEventSink<RE::TESActiveEffectApplyRemoveEvent>(this);
+		scriptEventSourceHolder->AddEventSink<RE::TESObjectLoadedEvent>(this);
+		_bRegistered = true;
+	}
+}
+
+int32_t ConditionFactCache::GetItemCount(RE::TESObjectREFR* a_refr, RE::FormID a_formID)
+{
+	if (const auto index = GetInventoryIndex(a_refr)) {
+		if (const auto it = index->itemCounts.find(a_formID); it != index->itemCounts.end()) {
+			return it->second;
+		}
+	}
+
+	return 0;
+}
+
+int32_t ConditionFactCache::GetItemCountWithKeyword(RE::TESObjectREFR* a_refr, const RE::BGSKeyword* a_keyword)
+{
+	if (a_keyword) {
+		if (const auto index = GetInventoryIndex(a_refr)) {
+			if (const auto it = index->keywordCounts.find(a_keyword->GetFormID()); it != index->keywordCounts.end()) {
+				return it->second;
+			}
+		}
+	}
+
+	return 0;
+}
+
+int32_t ConditionFactCache::GetItemCountWithKeywordEditorID(RE::TESObjectREFR* a_refr, std::string_view a_editorID)
+{
+	if (const auto index = GetInventoryIndex(a_refr)) {
+		std::string lowerEditorID(a_editorID);
+		std::ranges::transform(lowerEditorID, lowerEditorID.begin(), [](char c) { return static_cast<char>(std::tolower(c)); });
+
+		if (const auto it = index->keywordEditorIDCounts.find(lowerEditorID); it != index->keywordEditorIDCounts.end()) {
+			return it->second;
+		}
+	}
+
+	return 0;
+}
+
+void ConditionFactCache::Invalidate(RE::FormID a_refrFormID, Dependency a_dependencies)
+{
+	if ((a_dependencies & Dependency::kInventory) != Dependency::kNone) {
+		WriteLocker locker(_inventoryIndicesLock);
+		_inventoryIndices.erase(a_refrFormID);
+	}
+
+	WriteLocker locker(_factsLock);
+
+	_refrGenerations[a_refrFormID] = ++_generation;
+
+	if (const auto it = _facts.find(a_refrFormID); it != _facts.end()) {
+		std::erase_if(it->second, [&](const auto& a_fact) {
+			return (GetFactDependency(GetFactType(a_fact.first)) & a_dependencies) != Dependency::kNone;
+		});
+
+		if (it->second.empty()) {
+			_facts.erase(it);
+		}
+	}
+}
+
+void ConditionFactCache::ClearRefr(RE::FormID a_refrFormID)
+{
+	{
+		WriteLocker locker(_inventoryIndicesLock);
+		_inventoryIndices.erase(a_refrFormID);
+	}
+
+	WriteLocker locker(_factsLock);
+
+	++_generation;
+	_facts.erase(a_refrFormID);
+	_refrGenerations.erase(a_refrFormID);
+}
+
+void ConditionFactCache::Clear()
+{
+	{
+		WriteLocker locker(_inventoryIndicesLock);
+		_inventoryIndices.clear();
+	}
+
+	WriteLocker locker(_factsLock);
+
+	++_generation;
+	_facts.clear();
+	_refrGenerations.clear();
+}
+
+uint64_t ConditionFactCache::GetRefrGeneration(const RE::TESObjectREFR* a_refr) const
+{
+	if (!a_refr) {
+		return 0;
+	}
+
+	ReadLocker locker(_factsLock);
+
+	if (const auto it = _refrGenerations.find(a_refr->GetFormID()); it != _refrGenerations.end()) {
+		return it->second;
+	}
+
+	return 0;
+}
+
+ConditionFactCache::Dependency ConditionFactCache::GetFactDependency(FactType a_type)
+{
+	switch (a_type) {
+	case FactType::kIsWorn:
+	case FactType::kWornHasKeyword:
+		return Dependency::kEquipment | Dependency::kInventory;
+	case FactType::kHasMagicEffect:
+	case FactType::kHasMagicEffectWithKeyword:
+		return Dependency::kMagicEffects;
+	}
+
+	return Dependency::kNone;
+}
+
+RE::BSEventNotifyControl ConditionFactCache::ProcessEvent(const RE::TESEquipEvent* a_event, RE::BSTEventSource<RE::TESEquipEvent>*)
+{
+	if (a_event && a_event->actor) {
+		// equipping an item can also add or remove enchantment effects
+		Invalidate(a_event->actor->GetFormID(), Dependency::kEquipment | Dependency::kMagicEffects);
+	}
+
+	return RE::BSEventNotifyControl::kContinue;
+}
+
+RE::BSEventNotifyControl ConditionFactCache::ProcessEvent(const RE::TESContainerChangedEvent* a_event, RE::BSTEventSource<RE::TESContainerChangedEvent>*)
+{
+	// the index is rebuilt on next use instead of being patched with the event's item count, as the event can arrive after the index was already built from the changed inventory
+	if (a_event) {
+		if (a_event->oldContainer) {
+			Invalidate(a_event->oldContainer, Dependency::kInventory);
+		}
+		if (a_event->newContainer) {
+			Invalidate(a_event->newContainer, Dependency::kInventory);
+		}
+	}
+
+	return RE::BSEventNotifyControl::kContinue;
+}
+
+RE::BSEventNotifyControl ConditionFactCache::ProcessEvent(const RE::TESMagicEffectApplyEvent* a_event, RE::BSTEventSource<RE::TESMagicEffectApplyEvent>*)
+{
+	if (a_event && a_event->target) {
+		Invalidate(a_event->target->GetFormID(), Dependency::kMagicEffects);
+	}
+
+	return RE::BSEventNotifyControl::kContinue;
+}
+
+RE::BSEventNotifyControl ConditionFactCache::ProcessEvent(const RE::TESActiveEffectApplyRemoveEvent* a_event, RE::BSTEventSource<RE::TESActiveEffectApplyRemoveEvent>*)
+{
+	if (a_event && a_event->target) {
+		Invalidate(a_event->target->GetFormID(), Dependency::kMagicEffects);
+	}
+
+	return RE::BSEventNotifyControl::kContinue;
+}
+
+RE::BSEventNotifyControl ConditionFactCache::ProcessEvent(const RE::TESObjectLoadedEvent* a_event, RE::BSTEventSource<RE::TESObjectLoadedEvent>*)
+{
+	// drop everything about a ref when its 3D gets unloaded or reloaded
+	if (a_event) {
+		ClearRefr(a_event->formID);
+	}
+
+	return RE::BSEventNotifyControl::kContinue;
+}
+
+bool ConditionFactCache::TryGetFact(RE::TESObjectREFR* a_refr, FactType a_type, RE::FormID a_formID, int32_t& a_outValue, uint64_t& a_outGeneration) const
+{
+	a_outGeneration = _generation;
+
+	if (!Settings::bEnableConditionFactCache || !_bRegistered || !a_refr) {
+		return false;
+	}
+
+	ReadLocker locker(_factsLock);
+
+	if (const auto refrIt = _facts.find(a_refr->GetFormID()); refrIt != _facts.end()) {
+		if (const auto factIt = refrIt->second.find(GetFactKey(a_type, a_formID)); factIt != refrIt->second.end()) {
+			a_outValue = factIt->second;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void ConditionFactCache::SetFact(RE::TESObjectREFR* a_refr, FactType a_type, RE::FormID a_formID, int32_t a_value, uint64_t a_generation)
+{
+	if (!Settings::bEnableConditionFactCache || !_bRegistered || !a_refr) {
+		return;
+	}
+
+	WriteLocker locker(_factsLock);
+
+	// an invalidating event came in while the fact was being computed, so it might already be out of date
+	if (_generation != a_generation) {
+		return;
+	}
+
+	_facts[a_refr->GetFormID()][GetFactKey(a_type, a_formID)] = a_value;
+}
+
+std::shared_ptr<const ConditionFactCache::InventoryIndex> ConditionFactCache::GetInventoryIndex(RE::TESObjectREFR* a_refr)
+{
+	if (!a_refr) {
+		return nullptr;
+	}
+
+	if (!Settings::bEnableConditionFactCache || !_bRegistered) {
+		return BuildInventoryIndex(a_refr);
+	}
+
+	const auto refrFormID = a_refr->GetFormID();
+
+	{
+		ReadLocker locker(_inventoryIndicesLock);
+		if (const auto it = _inventoryIndices.find(refrFormID); it != _inventoryIndices.end()) {
+			return it->second;
+		}
+	}
+
+	const uint64_t generation = _generation;
+	auto index = BuildInventoryIndex(a_refr);
+
+	WriteLocker locker(_inventoryIndicesLock);
+	if (_generation == generation) {
+		_inventoryIndices.emplace(refrFormID, index);
+	}
+
+	return index;
+}
+
+std::shared_ptr<const ConditionFactCache::InventoryIndex> ConditionFactCache::BuildInventoryIndex(RE::TESObjectREFR* a_refr)
+{
+	auto index = std::make_shared<InventoryIndex>();
+
+	const auto inventoryCounts = a_refr->GetInventoryCounts();
+	index->itemCounts.reserve(inventoryCounts.size());
+
+	// reused for every item, a keyword listed more than once on the same item still only counts the item once
+	std::vector<RE::FormID> itemKeywordIDs;
+	std::vector<std::string_view> itemKeywordEditorIDs;
+	std::string lowerEditorID;
+
+	const auto lessCaseInsensitive = [](std::string_view a_lhs, std::string_view a_rhs) {
+		return std::ranges::lexicographical_compare(a_lhs, a_rhs, [](char a, char b) { return std::tolower(a) < std::tolower(b); });
+	};
+	const auto equalCaseInsensitive = [](std::string_view a_lhs, std::string_view a_rhs) {
+		return std::ranges::equal(a_lhs, a_rhs, [](char a, char b) { return std::tolower(a) == std::tolower(b); });
+	};
+
+	for (const auto& [object, count] : inventoryCounts) {
+		if (!object || count == 0) {
+			continue;
+		}
+
+		index->itemCounts[object->GetFormID()] += count;
+
+		if (const auto keywordForm = object->As<RE::BGSKeywordForm>()) {
+			itemKeywordIDs.clear();
+			itemKeywordEditorIDs.clear();
+			for (uint32_t i = 0; i < keywordForm->numKeywords; ++i) {
+				if (const auto keyword = keywordForm->keywords[i]) {
+					itemKeywordIDs.emplace_back(keyword->GetFormID());
+					if (!keyword->formEditorID.empty()) {
+						itemKeywordEditorIDs.emplace_back(keyword->formEditorID.c_str());
+					}
+				}
+			}
+
+			std::ranges::sort(itemKeywordIDs);
+			const auto [firstDuplicateID, lastID] = std::ranges::unique(itemKeywordIDs);
+			itemKeywordIDs.erase(firstDuplicateID, lastID);
+			for (const auto keywordID : itemKeywordIDs) {
+				index->keywordCounts[keywordID] += count;
+			}
+
+			std::ranges::sort(itemKeywordEditorIDs, lessCaseInsensitive);
+			const auto [firstDuplicateEditorID, lastEditorID] = std::ranges::unique(itemKeywordEditorIDs, equalCaseInsensitive);
+			itemKeywordEditorIDs.erase(firstDuplicateEditorID, lastEditorID);
+			for (const auto editorID : itemKeywordEditorIDs) {
+				lowerEditorID.assign(editorID);
+				std::ranges::transform(lowerEditorID, lowerEditorID.begin(), [](char c) { return static_cast<char>(std::tolower(c)); });
+				index->keywordEditorIDCounts[lowerEditorID] += count;
+			}
+		}
+	}
+
+	return index;
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+// caches per-actor facts used by conditions that are expensive to compute (e.g. inventory scans), but only change on specific game events
+// facts are keyed by their content (fact type + form ID) instead of by condition, so identical conditions across different replacer mods share them
+// facts are populated lazily on first evaluation and invalidated by the event sinks below
+class ConditionFactCache :
+	public RE::BSTEventSink<RE::TESEquipEvent>,
+	public RE::BSTEventSink<RE::TESContainerChangedEvent>,
+	public RE::BSTEventSink<RE::TESMagicEffectApplyEvent>,
+	public RE::BSTEventSink<RE::TESActiveEffectApplyRemoveEvent>,
+	public RE::BSTEventSink<RE::TESObjectLoadedEvent>
+{
+public:
+	enum class FactType : uint8_t
+	{
+		kIsWorn,
+		kWornHasKeyword,
+		kHasMagicEffect,
+		kHasMagicEffectWithKeyword
+	};
+
+	static ConditionFactCache& GetSingleton()
+	{
+		static ConditionFactCache singleton;
+		return singleton;
+	}
+
+	void RegisterEventSinks();
+
+	// returns the cached fact if present, otherwise computes it with the given function and caches the result
+	template <typename Func>
+	int32_t GetFact(RE::TESObjectREFR* a_refr, FactType a_type, RE::FormID a_formID, Func&& a_func)
+	{
+		int32_t value;
+		uint64_t generation;
+		if (TryGetFact(a_refr, a_type, a_formID, value, generation)) {
+			return value;
+		}
+
+		value = a_func();
+		SetFact(a_refr, a_type, a_formID, value, generation);
+		return value;
+	}
+
+	// inventory counts are answered from a per-actor index built from a single inventory scan on first use
+	int32_t GetItemCount(RE::TESObjectREFR* a_refr, RE::FormID a_formID);
+	int32_t GetItemCountWithKeyword(RE::TESObjectREFR* a_refr, const RE::BGSKeyword* a_keyword);
+	// counts each item with any keyword matching the editor ID once, for keyword literals that match more than one keyword form
+	int32_t GetItemCountWithKeywordEditorID(RE::TESObjectREFR* a_refr, std::string_view a_editorID);
+
+	// changes whenever any fact of the refr is invalidated, used to re-evaluate throttled interrupt checks early
+	[[nodiscard]] uint64_t GetRefrGeneration(const RE::TESObjectREFR* a_refr) const;
+
+	void ClearRefr(RE::FormID a_refrFormID);
+	void Clear();
+
+	// override BSTEventSink
+	RE::BSEventNotifyControl ProcessEvent(const RE::TESEquipEvent* a_event, RE::BSTEventSource<RE::TESEquipEvent>* a_eventSource) override;
+	RE::BSEventNotifyControl ProcessEvent(const RE::TESContainerChangedEvent* a_event, RE::BSTEventSource<RE::TESContainerChangedEvent>* a_eventSource) override;
+	RE::BSEventNotifyControl ProcessEvent(const RE::TESMagicEffectApplyEvent* a_event, RE::BSTEventSource<RE::TESMagicEffectApplyEvent>* a_eventSource) override;
+	RE::BSEventNotifyControl ProcessEvent(const RE::TESActiveEffectApplyRemoveEvent* a_event, RE::BSTEventSource<RE::TESActiveEffectApplyRemoveEvent>* a_eventSource) override;
+	RE::BSEventNotifyControl ProcessEvent(const RE::TESObjectLoadedEvent* a_event, RE::BSTEventSource<RE::TESObjectLoadedEvent>* a_eventSource) override;
+
+private:
+	ConditionFactCache() = default;
+	ConditionFactCache(const ConditionFactCache&) = delete;
+	ConditionFactCache(ConditionFactCache&&) = delete;
+	virtual ~ConditionFactCache() = default;
+
+	ConditionFactCache& operator=(const ConditionFactCache&) = delete;
+	ConditionFactCache& operator=(ConditionFactCache&&) = delete;
+
+	// game state a fact depends on, invalidated by the event sinks
+	enum class Dependency : uint8_t
+	{
+		kNone = 0,
+		kEquipment = 1 << 0,
+		kInventory = 1 << 1,
+		kMagicEffects = 1 << 2
+	};
+	friend constexpr Dependency operator|(Dependency a, Dependency b) { return static_cast<Dependency>(static_cast<uint8_t>(a) | static_cast<uint8_t>(b)); }
+	friend constexpr Dependency operator&(Dependency a, Dependency b) { return static_cast<Dependency>(static_cast<uint8_t>(a) & static_cast<uint8_t>(b)); }
+
+	struct InventoryIndex
+	{
+		std::unordered_map<RE::FormID, int32_t> itemCounts;
+		std::unordered_map<RE::FormID, int32_t> keywordCounts;
+		std::unordered_map<std::string, int32_t> keywordEditorIDCounts;  // lowercase editor IDs, matched case insensitively like keyword literals
+	};
+
+	static constexpr uint64_t GetFactKey(FactType a_type, RE::FormID a_formID) { return (static_cast<uint64_t>(a_type) << 32) | a_formID; }
+	static constexpr FactType GetFactType(uint64_t a_key) { return static_cast<FactType>(a_key >> 32); }
+
+	void Invalidate(RE::FormID a_refrFormID, Dependency a_dependencies);
+	[[nodiscard]] static Dependency GetFactDependency(FactType a_type);
+
+	bool TryGetFact(RE::TESObjectREFR* a_refr, FactType a_type, RE::FormID a_formID, int32_t& a_outValue, uint64_t& a_outGeneration) const;
+	void SetFact(RE::TESObjectREFR* a_refr, FactType a_type, RE::FormID a_formID, int32_t a_value, uint64_t a_generation);
+
+	std::shared_ptr<const InventoryIndex> GetInventoryIndex(RE::TESObjectREFR* a_refr);
+	static std::shared_ptr<const InventoryIndex> BuildInventoryIndex(RE::TESObjectREFR* a_refr);
+
+	mutable SharedLock _factsLock;
+	std::unordered_map<RE::FormID, std::unordered_map<uint64_t, int32_t>> _facts;
+	std::unordered_map<RE::FormID, uint64_t> _refrGenerations;
+
+	mutable SharedLock _inventoryIndicesLock;
+	std::unordered_map<RE::FormID, std::shared_ptr<const InventoryIndex>> _inventoryIndices;
+
+	// incremented on every invalidation, so a fact computed while an invalidating event was processed is not stored
+	std::atomic<uint64_t> _generation = 0;
+
+	bool _bRegistered = false;
+};
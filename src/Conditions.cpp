@@ -1,4 +1,5 @@
 #include "Conditions.h"
+#include "ConditionFactCache.h"
 #include "DetectedProblems.h"
 #include "Offsets.h"
 #include "OpenAnimationReplacer.h"
@@ -596,16 +597,21 @@ namespace Conditions
 	{
 		if (formComponent->IsValid() && a_refr) {
 			if (const auto actor = a_refr->As<RE::Actor>()) {
-				const auto inv = actor->GetInventory([this](const RE::TESBoundObject& a_object) {
-					return a_object.GetFormID() == formComponent->GetTESFormValue()->GetFormID();
-				});
+				const auto formID = formComponent->GetTESFormValue()->GetFormID();
+				return ConditionFactCache::GetSingleton().GetFact(actor, ConditionFactCache::FactType::kIsWorn, formID, [&]() -> int32_t {
+					const auto inv = actor->GetInventory([&](const RE::TESBoundObject& a_object) {
+						return a_object.GetFormID() == formID;
+					});
 
-				for (const auto& invData : inv | std::views::values) {
-					const auto& [count, entry] = invData;
-					if (count > 0 && entry->IsWorn()) {
-						return true;
+					for (const auto& invData : inv | std::views::values) {
+						const auto& [count, entry] = invData;
+						if (count > 0 && entry->IsWorn()) {
+							return true;
+						}
 					}
-				}
+
+					return false;
+				});
 			}
 		}
 
@@ -618,7 +624,10 @@ namespace Conditions
 			if (auto inventoryChanges = TESObjectREFR_GetInventoryChanges(a_refr)) {
 				bool bFound = false;
 				keywordComponent->keyword.ForEachKeyword([&](auto a_kywd) {
-					if (InventoryChanges_WornHasKeyword(inventoryChanges, a_kywd)) {
+					const bool bWornHasKeyword = ConditionFactCache::GetSingleton().GetFact(a_refr, ConditionFactCache::FactType::kWornHasKeyword, a_kywd->GetFormID(), [&]() -> int32_t {
+						return InventoryChanges_WornHasKeyword(inventoryChanges, a_kywd);
+					});
+					if (bWornHasKeyword) {
 						bFound = true;
 						return RE::BSContainer::ForEachResult::kStop;
 					}
@@ -730,6 +739,7 @@ namespace Conditions
 			if (const auto magicEffect = formComponent->GetTESFormValue()->As<RE::EffectSetting>()) {
 				if (const auto actor = a_refr->As<RE::Actor>()) {
 					const auto magicTarget = actor->AsMagicTarget();
+					auto& factCache = ConditionFactCache::GetSingleton();
 
 					if (boolComponent->GetBoolValue()) {
 						// active effects only, do the same thing as the game does but check the inactive flag as well
@@ -757,7 +767,9 @@ namespace Conditions
 							}
 						}
 					} else {
-						return magicTarget->HasMagicEffect(magicEffect);
+						return factCache.GetFact(actor, ConditionFactCache::FactType::kHasMagicEffect, magicEffect->GetFormID(), [&]() -> int32_t {
+							return magicTarget->HasMagicEffect(magicEffect);
+						});
 					}
 				}
 			}
@@ -786,6 +798,7 @@ namespace Conditions
 		if (keywordComponent->IsValid() && a_refr) {
 			if (const auto actor = a_refr->As<RE::Actor>()) {
 				auto magicTarget = actor->AsMagicTarget();
+				auto& factCache = ConditionFactCache::GetSingleton();
 
 				if (boolComponent->GetBoolValue()) {
 					// active effects only, do the same thing as the game does but check the inactive flag as well
@@ -801,7 +814,10 @@ namespace Conditions
 				} else {
 					bool bFound = false;
 					keywordComponent->keyword.ForEachKeyword([&](auto a_kywd) {
-						if (MagicTarget_HasMagicEffectWithKeyword(magicTarget, a_kywd, nullptr)) {
+						const bool bHasEffect = factCache.GetFact(actor, ConditionFactCache::FactType::kHasMagicEffectWithKeyword, a_kywd->GetFormID(), [&]() -> int32_t {
+							return MagicTarget_HasMagicEffectWithKeyword(magicTarget, a_kywd, nullptr);
+						});
+						if (bHasEffect) {
 							bFound = true;
 							return RE::BSContainer::ForEachResult::kStop;
 						}
@@ -1021,10 +1037,10 @@ namespace Conditions
 		return modff(time, &days) * 24.f;
 	}
 
-	float RandomCondition::RandomConditionStateData::GetRandomFloat()
+	float RandomCondition::RandomConditionStateData::GetRandomFloat(const RE::TESObjectREFR* a_refr, void* a_parentSubMod)
 	{
 		if (!_randomFloat.has_value()) {
-			_randomFloat = Utils::GetRandomFloat(_minValue, _maxValue);
+			_randomFloat = Utils::GetRandomFloat(_minValue, _maxValue, a_refr, static_cast<SubMod*>(a_parentSubMod));
 		}
 
 		return *_randomFloat;
@@ -1083,9 +1099,9 @@ namespace Conditions
 		}
 
 		if (data) {
-			randomFloat = static_cast<RandomConditionStateData*>(data)->GetRandomFloat();
+			randomFloat = static_cast<RandomConditionStateData*>(data)->GetRandomFloat(a_refr, a_parentSubMod);
 		} else {  // shouldn't happen normally
-			randomFloat = Utils::GetRandomFloat(minRandomComponent->GetNumericValue(a_refr), maxRandomComponent->GetNumericValue(a_refr));
+			randomFloat = Utils::GetRandomFloat(minRandomComponent->GetNumericValue(a_refr), maxRandomComponent->GetNumericValue(a_refr), a_refr, static_cast<SubMod*>(a_parentSubMod));
 		}
 
 		return comparisonComponent->GetComparisonResult(randomFloat, v);
@@ -1549,7 +1565,7 @@ namespace Conditions
 
 			// seems that the return is correct regardless of the type
 			float f;
-			return a_refr->GetGraphVariableFloat(textComponent->GetTextValue(), f);
+			return a_refr->GetGraphVariableFloat(textComponent->text.GetFixedValue(), f);
 		}
 
 		return false;
@@ -2121,14 +2137,7 @@ namespace Conditions
 
 		if (formComponent->IsValid() && a_refr) {
 			if (const auto actor = a_refr->As<RE::Actor>()) {
-				const auto inv = actor->GetInventory([this](const RE::TESBoundObject& a_object) {
-					return a_object.GetFormID() == formComponent->GetTESFormValue()->GetFormID();
-				});
-
-				for (const auto& invData : inv | std::views::values) {
-					const auto& [itemCount, entry] = invData;
-					count += itemCount;
-				}
+				count = ConditionFactCache::GetSingleton().GetItemCount(actor, formComponent->GetTESFormValue()->GetFormID());
 			}
 		}
 
@@ -3029,16 +3038,20 @@ namespace Conditions
 
 		if (keywordComponent->IsValid() && a_refr) {
 			if (const auto actor = a_refr->As<RE::Actor>()) {
-				const auto inv = actor->GetInventory([this](const RE::TESBoundObject& a_object) {
-					if (const auto bgsKeywordForm = a_object.As<RE::BGSKeywordForm>()) {
-						return keywordComponent->HasKeyword(bgsKeywordForm);
-					}
-					return false;
+				RE::BGSKeyword* firstKeyword = nullptr;
+				uint32_t numKeywords = 0;
+				keywordComponent->keyword.ForEachKeyword([&](auto a_kywd) {
+					firstKeyword = a_kywd;
+					++numKeywords;
+					return numKeywords > 1 ? RE::BSContainer::ForEachResult::kStop : RE::BSContainer::ForEachResult::kContinue;
 				});
 
-				for (const auto& invData : inv | std::views::values) {
-					const auto& [itemCount, entry] = invData;
-					count += itemCount;
+				auto& factCache = ConditionFactCache::GetSingleton();
+				if (numKeywords == 1) {
+					count = factCache.GetItemCountWithKeyword(actor, firstKeyword);
+				} else {
+					// only a literal matches more than one keyword, all sharing its editor ID. An item could have more than one of them, so count by editor ID instead of summing the per-keyword counts
+					count = factCache.GetItemCountWithKeywordEditorID(actor, keywordComponent->keyword.GetArgument());
 				}
 			}
 		}
@@ -2,6 +2,7 @@
 #include <rapidjson/document.h>
 
 #include "BaseConditions.h"
+#include "ObjectPool.h"
 
 namespace Conditions
 {
@@ -116,6 +117,7 @@ namespace Conditions
 		[[nodiscard]] RE::BSString GetName() const override { return "IsForm"sv.data(); }
 		[[nodiscard]] RE::BSString GetDescription() const override { return "Checks if the ref matches the specified form."sv.data(); }
 		[[nodiscard]] constexpr REL::Version GetRequiredVersion() const override { return { 1, 0, 0 }; }
+		[[nodiscard]] bool IsActorInvariant() const override { return true; }
 
 		FormConditionComponent* formComponent;
 
@@ -280,6 +282,7 @@ namespace Conditions
 		[[nodiscard]] RE::BSString GetName() const override { return "IsFemale"sv.data(); }
 		[[nodiscard]] RE::BSString GetDescription() const override { return "Checks if the ref is female."sv.data(); }
 		[[nodiscard]] constexpr REL::Version GetRequiredVersion() const override { return { 1, 0, 0 }; }
+		[[nodiscard]] bool IsActorInvariant() const override { return true; }
 
 	protected:
 		bool EvaluateImpl(RE::TESObjectREFR* a_refr, RE::hkbClipGenerator* a_clipGenerator, void* a_parentSubMod) const override;
@@ -291,6 +294,7 @@ namespace Conditions
 		[[nodiscard]] RE::BSString GetName() const override { return "IsChild"sv.data(); }
 		[[nodiscard]] RE::BSString GetDescription() const override { return "Checks if the ref is a child."sv.data(); }
 		[[nodiscard]] constexpr REL::Version GetRequiredVersion() const override { return { 1, 0, 0 }; }
+		[[nodiscard]] bool IsActorInvariant() const override { return true; }
 
 	protected:
 		bool EvaluateImpl(RE::TESObjectREFR* a_refr, RE::hkbClipGenerator* a_clipGenerator, void* a_parentSubMod) const override;
@@ -529,6 +533,7 @@ namespace Conditions
 		[[nodiscard]] RE::BSString GetName() const override { return "IsActorBase"sv.data(); }
 		[[nodiscard]] RE::BSString GetDescription() const override { return "Checks if the ref's actor base form is the specified form."sv.data(); }
 		[[nodiscard]] constexpr REL::Version GetRequiredVersion() const override { return { 1, 0, 0 }; }
+		[[nodiscard]] bool IsActorInvariant() const override { return true; }
 
 		FormConditionComponent* formComponent;
 
@@ -552,6 +557,7 @@ namespace Conditions
 		[[nodiscard]] RE::BSString GetName() const override { return "IsRace"sv.data(); }
 		[[nodiscard]] RE::BSString GetDescription() const override { return "Checks if the ref's race is the specified race."sv.data(); }
 		[[nodiscard]] constexpr REL::Version GetRequiredVersion() const override { return { 1, 0, 0 }; }
+		[[nodiscard]] bool IsActorInvariant() const override { return true; }
 
 		FormConditionComponent* formComponent;
 
@@ -611,7 +617,7 @@ namespace Conditions
 	class RandomCondition : public ConditionBase
 	{
 	public:
-		class RandomConditionStateData : public IStateData
+		class RandomConditionStateData : public IStateData, public PoolAllocated<RandomConditionStateData>
 		{
 		public:
 			static IStateData* Create() { return new RandomConditionStateData(); }
@@ -625,7 +631,7 @@ namespace Conditions
 
 			bool ShouldResetOnLoopOrEcho([[maybe_unused]] RE::hkbClipGenerator* a_clipGenerator, [[maybe_unused]] bool a_bIsEcho) const override { return _bResetOnLoopOrEcho; }
 
-			float GetRandomFloat();
+			float GetRandomFloat(const RE::TESObjectREFR* a_refr, void* a_parentSubMod);
 
 		protected:
 			bool _bResetOnLoopOrEcho = false;
@@ -672,6 +678,7 @@ namespace Conditions
 		[[nodiscard]] RE::BSString GetName() const override { return "IsUnique"sv.data(); }
 		[[nodiscard]] RE::BSString GetDescription() const override { return "Checks if the ref is flagged as unique."sv.data(); }
 		[[nodiscard]] constexpr REL::Version GetRequiredVersion() const override { return { 1, 0, 0 }; }
+		[[nodiscard]] bool IsActorInvariant() const override { return true; }
 
 	protected:
 		bool EvaluateImpl(RE::TESObjectREFR* a_refr, RE::hkbClipGenerator* a_clipGenerator, void* a_parentSubMod) const override;
@@ -692,6 +699,7 @@ namespace Conditions
 		[[nodiscard]] RE::BSString GetName() const override { return "IsClass"sv.data(); }
 		[[nodiscard]] RE::BSString GetDescription() const override { return "Checks if the ref's class is the specified class."sv.data(); }
 		[[nodiscard]] constexpr REL::Version GetRequiredVersion() const override { return { 1, 0, 0 }; }
+		[[nodiscard]] bool IsActorInvariant() const override { return true; }
 
 		FormConditionComponent* formComponent;
 
@@ -715,6 +723,7 @@ namespace Conditions
 		[[nodiscard]] RE::BSString GetName() const override { return "IsCombatStyle"sv.data(); }
 		[[nodiscard]] RE::BSString GetDescription() const override { return "Checks if the ref's combat style is the specified combat style."sv.data(); }
 		[[nodiscard]] constexpr REL::Version GetRequiredVersion() const override { return { 1, 0, 0 }; }
+		[[nodiscard]] bool IsActorInvariant() const override { return true; }
 
 		FormConditionComponent* formComponent;
 
@@ -738,6 +747,7 @@ namespace Conditions
 		[[nodiscard]] RE::BSString GetName() const override { return "IsVoiceType"sv.data(); }
 		[[nodiscard]] RE::BSString GetDescription() const override { return "Checks if the ref's voice type is the specified voice type."sv.data(); }
 		[[nodiscard]] constexpr REL::Version GetRequiredVersion() const override { return { 1, 0, 0 }; }
+		[[nodiscard]] bool IsActorInvariant() const override { return true; }
 
 		FormConditionComponent* formComponent;
 
@@ -2337,7 +2347,7 @@ namespace Conditions
 	class MovementSurfaceAngleCondition : public ConditionBase
 	{
 	public:
-		class MovementSurfaceAngleConditionStateData : public IStateData
+		class MovementSurfaceAngleConditionStateData : public IStateData, public PoolAllocated<MovementSurfaceAngleConditionStateData>
 		{
 		public:
 			static IStateData* Create() { return new MovementSurfaceAngleConditionStateData(); }
@@ -2388,6 +2398,7 @@ namespace Conditions
 		[[nodiscard]] RE::BSString GetName() const override { return "MovementSurfaceAngle"sv.data(); }
 		[[nodiscard]] RE::BSString GetDescription() const override { return "Tests the angle of the surface that the ref is walking on against a numeric value.\nThe angle is calculated by comparing the surface's normal vector and the ref's forward vector."sv.data(); }
 		[[nodiscard]] constexpr REL::Version GetRequiredVersion() const override { return { 2, 3, 0 }; }
+		[[nodiscard]] bool HasTickingStateData() const override { return true; }
 
 		float GetSmoothingFactor(RE::TESObjectREFR* a_refr) const { return smoothingFactorComponent->GetNumericValue(a_refr); }
 
@@ -2574,7 +2585,7 @@ namespace Conditions
 	class IdleTimeCondition : public ConditionBase
 	{
 	public:
-		class IdleTimeConditionStateData : public IStateData
+		class IdleTimeConditionStateData : public IStateData, public PoolAllocated<IdleTimeConditionStateData>
 		{
 		public:
 			static IStateData* Create() { return new IdleTimeConditionStateData(); }
@@ -2608,6 +2619,7 @@ namespace Conditions
 		[[nodiscard]] RE::BSString GetName() const override { return "IdleTime"sv.data(); }
 		[[nodiscard]] RE::BSString GetDescription() const override { return "Compares the time the actor has spent idling with a numeric value."sv.data(); }
 		[[nodiscard]] constexpr REL::Version GetRequiredVersion() const override { return { 2, 3, 0 }; }
+		[[nodiscard]] bool HasTickingStateData() const override { return true; }
 
 		ComparisonConditionComponent* comparisonComponent;
 		NumericConditionComponent* numericComponent;
@@ -38,11 +38,12 @@ FakeClipGenerator::FakeClipGenerator(RE::hkbClipGenerator* a_clipGenerator, bool
 
 FakeClipGenerator::FakeClipGenerator(RE::hkbBehaviorGraph* a_behaviorGraph, const ReplacementAnimation* a_replacementAnimation, std::string_view a_syncAnimationPrefix, Variant* a_variant)
 {
+	const RE::BShkbAnimationGraph* graph = reinterpret_cast<RE::BShkbAnimationGraph*>(a_behaviorGraph->userData);
+
 	syncAnimationPrefix = a_syncAnimationPrefix;
-	animationBindingIndex = a_variant ? a_variant->GetIndex() : a_replacementAnimation->GetIndex(a_variant);
+	animationBindingIndex = a_variant ? a_variant->GetIndex() : a_replacementAnimation->GetIndex(graph->holder, a_variant);
 	mode = RE::hkbClipGenerator::PlaybackMode::kModeLooping;
 
-	const RE::BShkbAnimationGraph* graph = reinterpret_cast<RE::BShkbAnimationGraph*>(a_behaviorGraph->userData);
 	const RE::hkbCharacter* character = &graph->characterInstance;
 	const RE::hkbContext* context = reinterpret_cast<RE::hkbContext*>(&character);
 	Activate(*context);
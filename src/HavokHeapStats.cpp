@@ -0,0 +1,142 @@
+#include "HavokHeapStats.h"
+
+#include <binary_io/binary_io.hpp>
+
+#include "Utils.h"
+
+void HavokHeapStats::StartTracking()
+{
+	_bTracking = true;
+
+	ReadHistoryFromDisk();
+}
+
+uint32_t HavokHeapStats::OnHeapCreated()
+{
+	_heapSize = Settings::uHavokHeapSize;
+
+	if (Settings::bAutoHavokHeapSize) {
+		if (const auto autoHeapSize = GetAutoHeapSize()) {
+			logger::info("Automatic havok heap size: 0x{:X} (previous peak usage: {:.1f} MB)", autoHeapSize, static_cast<double>(_previousPeakBytes) / (1024.0 * 1024.0));
+			_heapSize = autoHeapSize;
+		} else {
+			logger::info("Automatic havok heap size: no previous sessions recorded, using 0x{:X}", _heapSize);
+		}
+	}
+
+	return _heapSize;
+}
+
+HavokHeapStats::Snapshot HavokHeapStats::GetSnapshot() const
+{
+	Snapshot snapshot;
+
+	snapshot.currentBytes = static_cast<uint64_t>(std::max(_currentBytes.load(std::memory_order_relaxed), int64_t{ 0 }));
+	snapshot.peakBytes = static_cast<uint64_t>(_peakBytes.load(std::memory_order_relaxed));
+	snapshot.previousPeakBytes = _previousPeakBytes;
+	snapshot.heapSize = _heapSize;
+	for (size_t i = 0; i < kNumSizeClasses; ++i) {
+		snapshot.allocationCounts[i] = _allocationCounts[i].load(std::memory_order_relaxed);
+	}
+
+	return snapshot;
+}
+
+std::string_view HavokHeapStats::GetSizeClassName(size_t a_sizeClass)
+{
+	constexpr std::array<std::string_view, kNumSizeClasses> names = { "<= 64 B"sv, "<= 256 B"sv, "<= 1 KB"sv, "<= 4 KB"sv, "<= 16 KB"sv, "<= 64 KB"sv, "<= 256 KB"sv, "> 256 KB"sv };
+
+	return a_sizeClass < names.size() ? names[a_sizeClass] : ""sv;
+}
+
+void HavokHeapStats::WriteHistoryToDisk()
+{
+	const auto peakBytes = static_cast<uint64_t>(_peakBytes.load(std::memory_order_relaxed));
+	if (!_bTracking || peakBytes == 0) {
+		return;
+	}
+
+	Locker locker(_historyLock);
+
+	try {
+		binary_io::file_ostream out{ Settings::havokHeapStatsPath };
+
+		// keep the most recent sessions, this one included
+		const size_t numPrevious = std::min(_previousSessions.size(), static_cast<size_t>(Settings::uHavokHeapSessionHistory - 1));
+		out.write(static_cast<uint32_t>(numPrevious + 1));
+
+		for (size_t i = _previousSessions.size() - numPrevious; i < _previousSessions.size(); ++i) {
+			out.write(_previousSessions[i].peakBytes);
+			out.write(_previousSessions[i].heapSize);
+		}
+
+		out.write(peakBytes);
+		out.write(_heapSize);
+	} catch (const std::system_error& e) {
+		logger::warn("Failed to write havok heap stats: {}", e.what());
+	}
+}
+
+void HavokHeapStats::OnShutdown()
+{
+	if (!_bTracking || _bShutDown) {
+		return;
+	}
+
+	_bShutDown = true;
+
+	const auto snapshot = GetSnapshot();
+	logger::info("Havok heap peak usage: {:.1f} MB of {:.1f} MB", static_cast<double>(snapshot.peakBytes) / (1024.0 * 1024.0), static_cast<double>(snapshot.heapSize) / (1024.0 * 1024.0));
+
+	WriteHistoryToDisk();
+}
+
+void HavokHeapStats::ReadHistoryFromDisk()
+{
+	if (!Utils::Exists(Settings::havokHeapStatsPath)) {
+		return;
+	}
+
+	Locker locker(_historyLock);
+
+	try {
+		binary_io::file_istream in{ Settings::havokHeapStatsPath };
+
+		uint32_t numSessions;
+		in.read(numSessions);
+
+		for (uint32_t i = 0; i < numSessions; ++i) {
+			SessionRecord session;
+			in.read(session.peakBytes);
+			in.read(session.heapSize);
+			_previousSessions.emplace_back(session);
+			_previousPeakBytes = std::max(_previousPeakBytes, session.peakBytes);
+		}
+	} catch (const std::system_error& e) {
+		logger::warn("Failed to read havok heap stats: {}", e.what());
+		_previousSessions.clear();
+		_previousPeakBytes = 0;
+	}
+}
+
+uint32_t HavokHeapStats::GetAutoHeapSize() const
+{
+	Locker locker(_historyLock);
+
+	uint64_t requiredBytes = 0;
+	for (const auto& session : _previousSessions) {
+		// a session that (nearly) filled its heap might have needed more than it got, so at least the whole heap is required
+		const bool bWasFull = session.peakBytes >= static_cast<uint64_t>(session.heapSize * Settings::fHavokHeapFullThreshold);
+		requiredBytes = std::max(requiredBytes, bWasFull ? std::max(session.peakBytes, static_cast<uint64_t>(session.heapSize)) : session.peakBytes);
+	}
+
+	if (requiredBytes == 0) {
+		return 0;
+	}
+
+	// add headroom and round up to 16 MB
+	constexpr uint64_t alignment = 0x1000000;
+	const uint64_t heapSize = (static_cast<uint64_t>(requiredBytes * (1.f + Settings::fHavokHeapAutoHeadroom)) + alignment - 1) & ~(alignment - 1);
+
+	return static_cast<uint32_t>(std::clamp(heapSize, static_cast<uint64_t>(Settings::uHavokHeapSizeMin), static_cast<uint64_t>(Settings::uHavokHeapSizeMax)));
+}
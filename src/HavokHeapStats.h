@@ -0,0 +1,114 @@
+#pragma once
+
+#include "Settings.h"
+
+// usage accounting for the havok heap, fed by the hooked bhkThreadMemorySource allocation vfuncs
+// the peak usage of each session is saved to disk, so the heap size can be picked automatically based on what previous sessions actually needed
+class HavokHeapStats
+{
+public:
+	// <=64B, <=256B, <=1KB, <=4KB, <=16KB, <=64KB, <=256KB, larger
+	static constexpr size_t kNumSizeClasses = 8;
+
+	struct Snapshot
+	{
+		uint64_t currentBytes = 0;
+		uint64_t peakBytes = 0;
+		uint64_t previousPeakBytes = 0;
+		uint32_t heapSize = 0;
+		std::array<uint64_t, kNumSizeClasses> allocationCounts{};
+	};
+
+	// the default implementations of some of the allocator vfuncs call the others, so only the outermost call on a thread is counted
+	class CallScope
+	{
+	public:
+		CallScope() { ++_depth; }
+		~CallScope() { --_depth; }
+
+		CallScope(const CallScope&) = delete;
+		CallScope& operator=(const CallScope&) = delete;
+
+		[[nodiscard]] bool IsOutermost() const { return _depth == 1; }
+
+	private:
+		static inline thread_local uint32_t _depth = 0;
+	};
+
+	static HavokHeapStats& GetSingleton()
+	{
+		static HavokHeapStats singleton;
+		return singleton;
+	}
+
+	// read at startup, the allocation hooks are only installed if this is enabled
+	[[nodiscard]] static bool ShouldTrack() { return Settings::bEnableHavokHeapTelemetry || Settings::bAutoHavokHeapSize; }
+
+	void StartTracking();
+	[[nodiscard]] bool IsTracking() const { return _bTracking; }
+
+	// called when the heap is created, returns the size it should be created with
+	uint32_t OnHeapCreated();
+
+	void OnAlloc(int32_t a_numBytes, int32_t a_count = 1)
+	{
+		const int64_t current = _currentBytes.fetch_add(static_cast<int64_t>(a_numBytes) * a_count, std::memory_order_relaxed) + static_cast<int64_t>(a_numBytes) * a_count;
+		int64_t peak = _peakBytes.load(std::memory_order_relaxed);
+		while (current > peak && !_peakBytes.compare_exchange_weak(peak, current, std::memory_order_relaxed)) {}
+
+		_allocationCounts[GetSizeClass(a_numBytes)].fetch_add(a_count, std::memory_order_relaxed);
+	}
+
+	void OnFree(int32_t a_numBytes, int32_t a_count = 1)
+	{
+		_currentBytes.fetch_sub(static_cast<int64_t>(a_numBytes) * a_count, std::memory_order_relaxed);
+	}
+
+	[[nodiscard]] Snapshot GetSnapshot() const;
+	[[nodiscard]] static std::string_view GetSizeClassName(size_t a_sizeClass);
+
+	// saves the peak of this session, called on every save as well so it's remembered even if the game doesn't exit cleanly
+	void WriteHistoryToDisk();
+
+	// logs the peak usage and saves it, called once from the main update when the game is quitting
+	void OnShutdown();
+
+private:
+	HavokHeapStats() = default;
+	HavokHeapStats(const HavokHeapStats&) = delete;
+	HavokHeapStats(HavokHeapStats&&) = delete;
+	~HavokHeapStats() = default;
+
+	HavokHeapStats& operator=(const HavokHeapStats&) = delete;
+	HavokHeapStats& operator=(HavokHeapStats&&) = delete;
+
+	struct SessionRecord
+	{
+		uint64_t peakBytes;
+		uint32_t heapSize;
+	};
+
+	static size_t GetSizeClass(int32_t a_numBytes)
+	{
+		if (a_numBytes <= 64) {
+			return 0;
+		}
+
+		return std::min((static_cast<size_t>(std::bit_width(static_cast<uint32_t>(a_numBytes - 1))) - 5) / 2, kNumSizeClasses - 1);
+	}
+
+	void ReadHistoryFromDisk();
+	[[nodiscard]] uint32_t GetAutoHeapSize() const;
+
+	bool _bTracking = false;
+	bool _bShutDown = false;
+	uint32_t _heapSize = 0;
+
+	std::atomic<int64_t> _currentBytes = 0;
+	std::atomic<int64_t> _peakBytes = 0;
+	std::array<std::atomic<uint64_t>, kNumSizeClasses> _allocationCounts{};
+
+	mutable ExclusiveLock _historyLock;
+	std::vector<SessionRecord> _previousSessions;
+	uint64_t _previousPeakBytes = 0;
+};
@@ -1,6 +1,7 @@
 #include "Hooks.h"
 
 #include "AnimationEventLog.h"
+#include "AnimationLoader.h"
 
 #include <xbyak/xbyak.h>
 
@@ -31,9 +32,13 @@ namespace Hooks
 	{
 		OpenAnimationReplacer::gameTimeCounter += g_deltaTime;
 		OpenAnimationReplacer::GetSingleton().RunJobs();
+		AnimationLoader::GetSingleton().Update();
 		if (!RE::UI::GetSingleton()->GameIsPaused()) {
 			OpenAnimationReplacer::GetSingleton().RunStateDataUpdates();
 		}
+		if (RE::Main::GetSingleton()->quitGame) {
+			HavokHeapStats::GetSingleton().OnShutdown();
+		}
 		_Nullsub();
 	}
 
@@ -270,7 +275,7 @@ namespace Hooks
 
 	bool HavokHooks::Unk3(RE::BShkbAnimationGraph* a_graph, const char* a_fileName, bool a3)
 	{
-		// queue all the replacement animations to be preloaded
+		// schedule all the replacement animations to be preloaded, they're submitted to the game's queue over the next frames by priority
 		// I think this technically means they will never unload
 		// but this is how we definitely avoid the reference pose showing up
 		// in my experience this is not necessary with all the other hooks properly loading the correct animations, but it might rely on your system being fast enough to load them in time
@@ -283,7 +288,7 @@ namespace Hooks
 					if (const auto& characterData = setup->data) {
 						if (const auto& stringData = characterData->stringData) {
 							if (const auto projectData = OpenAnimationReplacer::GetSingleton().GetReplacerProjectData(stringData.get())) {
-								projectData->QueueReplacementAnimations(&a_graph->characterInstance);
+								AnimationLoader::GetSingleton().SchedulePreload(a_graph, projectData);
 							}
 						}
 					}
@@ -296,7 +301,84 @@ namespace Hooks
 
 	RE::bhkThreadMemorySource* HavokHooks::bhkThreadMemorySource_ctor(RE::bhkThreadMemorySource* a_this, [[maybe_unused]] uint32_t a_size)
 	{
-		return _bhkThreadMemorySource_ctor(a_this, Settings::uHavokHeapSize);
+		return _bhkThreadMemorySource_ctor(a_this, HavokHeapStats::GetSingleton().OnHeapCreated());
+	}
+
+	void* HavokHooks::bhkThreadMemorySource_BlockAlloc(RE::bhkThreadMemorySource* a_this, int32_t a_numBytes)
+	{
+		const HavokHeapStats::CallScope scope;
+		const auto ret = _bhkThreadMemorySource_BlockAlloc(a_this, a_numBytes);
+		if (ret && scope.IsOutermost()) {
+			HavokHeapStats::GetSingleton().OnAlloc(a_numBytes);
+		}
+
+		return ret;
+	}
+
+	void HavokHooks::bhkThreadMemorySource_BlockFree(RE::bhkThreadMemorySource* a_this, void* a_ptr, int32_t a_numBytes)
+	{
+		const HavokHeapStats::CallScope scope;
+		if (a_ptr && scope.IsOutermost()) {
+			HavokHeapStats::GetSingleton().OnFree(a_numBytes);
+		}
+
+		_bhkThreadMemorySource_BlockFree(a_this, a_ptr, a_numBytes);
+	}
+
+	void* HavokHooks::bhkThreadMemorySource_BufAlloc(RE::bhkThreadMemorySource* a_this, int32_t& a_reqNumBytesInOut)
+	{
+		const HavokHeapStats::CallScope scope;
+		const auto ret = _bhkThreadMemorySource_BufAlloc(a_this, a_reqNumBytesInOut);
+		// the allocator can hand out more than requested, the actual size is written back
+		if (ret && scope.IsOutermost()) {
+			HavokHeapStats::GetSingleton().OnAlloc(a_reqNumBytesInOut);
+		}
+
+		return ret;
+	}
+
+	void HavokHooks::bhkThreadMemorySource_BufFree(RE::bhkThreadMemorySource* a_this, void* a_ptr, int32_t a_numBytes)
+	{
+		const HavokHeapStats::CallScope scope;
+		if (a_ptr && scope.IsOutermost()) {
+			HavokHeapStats::GetSingleton().OnFree(a_numBytes);
+		}
+
+		_bhkThreadMemorySource_BufFree(a_this, a_ptr, a_numBytes);
+	}
+
+	void* HavokHooks::bhkThreadMemorySource_BufRealloc(RE::bhkThreadMemorySource* a_this, void* a_old, int32_t a_oldNumBytes, int32_t& a_reqNumBytesInOut)
+	{
+		const HavokHeapStats::CallScope scope;
+		const auto ret = _bhkThreadMemorySource_BufRealloc(a_this, a_old, a_oldNumBytes, a_reqNumBytesInOut);
+		if (ret && scope.IsOutermost()) {
+			auto& heapStats = HavokHeapStats::GetSingleton();
+			if (a_old) {
+				heapStats.OnFree(a_oldNumBytes);
+			}
+			heapStats.OnAlloc(a_reqNumBytesInOut);
+		}
+
+		return ret;
+	}
+
+	void HavokHooks::bhkThreadMemorySource_BlockAllocBatch(RE::bhkThreadMemorySource* a_this, void** a_ptrsOut, int32_t a_numPtrs, int32_t a_blockSize)
+	{
+		const HavokHeapStats::CallScope scope;
+		_bhkThreadMemorySource_BlockAllocBatch(a_this, a_ptrsOut, a_numPtrs, a_blockSize);
+		if (scope.IsOutermost()) {
+			HavokHeapStats::GetSingleton().OnAlloc(a_blockSize, a_numPtrs);
+		}
+	}
+
+	void HavokHooks::bhkThreadMemorySource_BlockFreeBatch(RE::bhkThreadMemorySource* a_this, void** a_ptrsIn, int32_t a_numPtrs, int32_t a_blockSize)
+	{
+		const HavokHeapStats::CallScope scope;
+		if (scope.IsOutermost()) {
+			HavokHeapStats::GetSingleton().OnFree(a_blockSize, a_numPtrs);
+		}
+
+		_bhkThreadMemorySource_BlockFreeBatch(a_this, a_ptrsIn, a_numPtrs, a_blockSize);
 	}
 
 	void HavokHooks::PatchSynchronizedClips()
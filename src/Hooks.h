@@ -1,4 +1,5 @@
 #pragma once
+#include "HavokHeapStats.h"
 #include "OpenAnimationReplacer.h"
 
 #include <windows.h>
@@ -56,6 +57,19 @@ namespace Hooks
 			SKSE::AllocTrampoline(14);
 			_bhkThreadMemorySource_ctor = trampoline.write_call<5>(havokMemoryCtorHook.address() + 0x29, bhkThreadMemorySource_ctor);
 
+			// Track havok heap usage
+			if (HavokHeapStats::ShouldTrack()) {
+				REL::Relocation<uintptr_t> bhkThreadMemorySourceVtbl{ RE::VTABLE_bhkThreadMemorySource[0] };
+				_bhkThreadMemorySource_BlockAlloc = bhkThreadMemorySourceVtbl.write_vfunc(0x1, bhkThreadMemorySource_BlockAlloc);
+				_bhkThreadMemorySource_BlockFree = bhkThreadMemorySourceVtbl.write_vfunc(0x2, bhkThreadMemorySource_BlockFree);
+				_bhkThreadMemorySource_BufAlloc = bhkThreadMemorySourceVtbl.write_vfunc(0x3, bhkThreadMemorySource_BufAlloc);
+				_bhkThreadMemorySource_BufFree = bhkThreadMemorySourceVtbl.write_vfunc(0x4, bhkThreadMemorySource_BufFree);
+				_bhkThreadMemorySource_BufRealloc = bhkThreadMemorySourceVtbl.write_vfunc(0x5, bhkThreadMemorySource_BufRealloc);
+				_bhkThreadMemorySource_BlockAllocBatch = bhkThreadMemorySourceVtbl.write_vfunc(0x6, bhkThreadMemorySource_BlockAllocBatch);
+				_bhkThreadMemorySource_BlockFreeBatch = bhkThreadMemorySourceVtbl.write_vfunc(0x7, bhkThreadMemorySource_BlockFreeBatch);
+				HavokHeapStats::GetSingleton().StartTracking();
+			}
+
 			// Fix anim IDs getting overwritten
 			const REL::Relocation<uintptr_t> loadClipsHook{ REL::VariantID(63032, 63885, 0xB41E00) };                      // B06FC0, B28940, B41E00  hkbBehaviorLoadingUtils::loadClips presumably, or an internal one in case of AE (got uninlined)
 			uint8_t patch1[] = { 0x90, 0x90, 0x90 };                                                                       // nop
@@ -108,6 +122,13 @@ namespace Hooks
 		static bool CreateSynchronizedClips(RE::hkbBehaviorGraph* a_behaviorGraph, RE::hkbCharacter* a_character, RE::BSTHashMap<RE::BSFixedString, uint32_t>* a_annotationToEventIdMap);
 
 		static RE::bhkThreadMemorySource* bhkThreadMemorySource_ctor(RE::bhkThreadMemorySource* a_this, uint32_t a_size);
+		static void* bhkThreadMemorySource_BlockAlloc(RE::bhkThreadMemorySource* a_this, int32_t a_numBytes);
+		static void bhkThreadMemorySource_BlockFree(RE::bhkThreadMemorySource* a_this, void* a_ptr, int32_t a_numBytes);
+		static void* bhkThreadMemorySource_BufAlloc(RE::bhkThreadMemorySource* a_this, int32_t& a_reqNumBytesInOut);
+		static void bhkThreadMemorySource_BufFree(RE::bhkThreadMemorySource* a_this, void* a_ptr, int32_t a_numBytes);
+		static void* bhkThreadMemorySource_BufRealloc(RE::bhkThreadMemorySource* a_this, void* a_old, int32_t a_oldNumBytes, int32_t& a_reqNumBytesInOut);
+		static void bhkThreadMemorySource_BlockAllocBatch(RE::bhkThreadMemorySource* a_this, void** a_ptrsOut, int32_t a_numPtrs, int32_t a_blockSize);
+		static void bhkThreadMemorySource_BlockFreeBatch(RE::bhkThreadMemorySource* a_this, void** a_ptrsIn, int32_t a_numPtrs, int32_t a_blockSize);
 
 		static bool Unk3(RE::BShkbAnimationGraph* a_graph, const char* a_fileName, bool a3);
 
@@ -134,6 +155,13 @@ namespace Hooks
 		static inline REL::Relocation<decltype(CreateSynchronizedClips)> _CreateSynchronizedClips;
 
 		static inline REL::Relocation<decltype(bhkThreadMemorySource_ctor)> _bhkThreadMemorySource_ctor;
+		static inline REL::Relocation<decltype(bhkThreadMemorySource_BlockAlloc)> _bhkThreadMemorySource_BlockAlloc;
+		static inline REL::Relocation<decltype(bhkThreadMemorySource_BlockFree)> _bhkThreadMemorySource_BlockFree;
+		static inline REL::Relocation<decltype(bhkThreadMemorySource_BufAlloc)> _bhkThreadMemorySource_BufAlloc;
+		static inline REL::Relocation<decltype(bhkThreadMemorySource_BufFree)> _bhkThreadMemorySource_BufFree;
+		static inline REL::Relocation<decltype(bhkThreadMemorySource_BufRealloc)> _bhkThreadMemorySource_BufRealloc;
+		static inline REL::Relocation<decltype(bhkThreadMemorySource_BlockAllocBatch)> _bhkThreadMemorySource_BlockAllocBatch;
+		static inline REL::Relocation<decltype(bhkThreadMemorySource_BlockFreeBatch)> _bhkThreadMemorySource_BlockFreeBatch;
 
 		static inline REL::Relocation<decltype(Unk3)> _Unk3;
 
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <array>
+
+// bounded lock-free queue with any number of producers and a single consumer (based on Dmitry Vyukov's bounded MPMC queue)
+// producers never block or allocate - when the queue is full, the pushed value is dropped
+template <typename T, size_t Capacity>
+class MPSCRingBuffer
+{
+	static_assert(std::has_single_bit(Capacity), "Capacity has to be a power of two");
+	static_assert(std::is_trivially_copyable_v<T>, "Values are copied in and out of the slots");
+
+public:
+	MPSCRingBuffer()
+	{
+		for (size_t i = 0; i < Capacity; ++i) {
+			_slots[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	MPSCRingBuffer(const MPSCRingBuffer&) = delete;
+	MPSCRingBuffer(MPSCRingBuffer&&) = delete;
+	MPSCRingBuffer& operator=(const MPSCRingBuffer&) = delete;
+	MPSCRingBuffer& operator=(MPSCRingBuffer&&) = delete;
+
+	// can be called from any thread
+	bool TryPush(const T& a_value)
+	{
+		size_t position = _head.load(std::memory_order_relaxed);
+
+		while (true) {
+			auto& slot = _slots[position & (Capacity - 1)];
+			const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+			const auto difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+
+			if (difference == 0) {
+				// the slot is free, try to claim it
+				if (_head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+					slot.value = a_value;
+					slot.sequence.store(position + 1, std::memory_order_release);
+					return true;
+				}
+			} else if (difference < 0) {
+				// full, the consumer hasn't read the value in this slot yet
+				return false;
+			} else {
+				// another producer claimed the slot first
+				position = _head.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	// has to be called from a single thread only
+	bool TryPop(T& a_outValue)
+	{
+		auto& slot = _slots[_tail & (Capacity - 1)];
+		if (slot.sequence.load(std::memory_order_acquire) != _tail + 1) {
+			return false;
+		}
+
+		a_outValue = slot.value;
+		slot.sequence.store(_tail + Capacity, std::memory_order_release);
+		++_tail;
+
+		return true;
+	}
+
+private:
+	struct Slot
+	{
+		std::atomic<size_t> sequence;
+		T value;
+	};
+
+	std::array<Slot, Capacity> _slots;
+
+	// keep the producer and consumer positions on separate cache lines
+	alignas(64) std::atomic<size_t> _head = 0;
+	alignas(64) size_t _tail = 0;
+};
@@ -0,0 +1,73 @@
+#include "ObjectPool.h"
+
+ObjectPool::ObjectPool(std::string_view a_name, size_t a_objectSize, size_t a_alignment, size_t a_objectsPerSlab) :
+	_name(a_name),
+	_alignment(std::max(a_alignment, alignof(FreeNode))),
+	_objectsPerSlab(a_objectsPerSlab)
+{
+	// every slot has to be able to hold a free list node and keep the following slots aligned
+	_objectSize = std::max(a_objectSize, sizeof(FreeNode));
+	_objectSize = (_objectSize + _alignment - 1) & ~(_alignment - 1);
+
+	Locker locker(_poolsLock);
+	_pools.emplace_back(this);
+}
+
+void* ObjectPool::Allocate()
+{
+	Locker locker(_lock);
+
+	if (!_freeList) {
+		AllocateSlab();
+	}
+
+	const auto node = _freeList;
+	_freeList = node->next;
+
+	++_stats.allocations;
+	++_stats.liveObjects;
+
+	return node;
+}
+
+void ObjectPool::Deallocate(void* a_ptr)
+{
+	Locker locker(_lock);
+
+	const auto node = static_cast<FreeNode*>(a_ptr);
+	node->next = _freeList;
+	_freeList = node;
+
+	--_stats.liveObjects;
+}
+
+ObjectPool::Stats ObjectPool::GetStats() const
+{
+	Locker locker(_lock);
+
+	return _stats;
+}
+
+void ObjectPool::LogStats()
+{
+	Locker locker(_poolsLock);
+
+	for (const auto pool : _pools) {
+		const auto stats = pool->GetStats();
+		logger::info("Object pool {}: {} allocations served from {} heap allocations, {} live", pool->GetName(), stats.allocations, stats.heapAllocations, stats.liveObjects);
+	}
+}
+
+void ObjectPool::AllocateSlab()
+{
+	const auto slab = static_cast<std::byte*>(::operator new(_objectSize * _objectsPerSlab, std::align_val_t{ _alignment }));
+
+	// push the slots in reverse so they get handed out in address order
+	for (size_t i = _objectsPerSlab; i > 0; --i) {
+		const auto node = reinterpret_cast<FreeNode*>(slab + (i - 1) * _objectSize);
+		node->next = _freeList;
+		_freeList = node;
+	}
+
+	++_stats.heapAllocations;
+}
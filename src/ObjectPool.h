@@ -0,0 +1,87 @@
+#pragma once
+
+// free list allocator for small objects of a single size that are created and destroyed all the time (e.g. condition state data)
+// memory is requested from the heap in slabs, which are kept around and reused instead of being freed
+class ObjectPool
+{
+public:
+	struct Stats
+	{
+		uint64_t allocations = 0;
+		uint64_t heapAllocations = 0;
+		uint64_t liveObjects = 0;
+	};
+
+	ObjectPool(std::string_view a_name, size_t a_objectSize, size_t a_alignment, size_t a_objectsPerSlab = 64);
+
+	// the slabs are intentionally leaked, pooled objects might still be alive during static destruction
+	~ObjectPool() = default;
+
+	ObjectPool(const ObjectPool&) = delete;
+	ObjectPool(ObjectPool&&) = delete;
+	ObjectPool& operator=(const ObjectPool&) = delete;
+	ObjectPool& operator=(ObjectPool&&) = delete;
+
+	[[nodiscard]] void* Allocate();
+	void Deallocate(void* a_ptr);
+
+	[[nodiscard]] std::string_view GetName() const { return _name; }
+	[[nodiscard]] Stats GetStats() const;
+
+	static void LogStats();
+
+private:
+	struct FreeNode
+	{
+		FreeNode* next;
+	};
+
+	void AllocateSlab();
+
+	std::string _name;
+	size_t _objectSize;
+	size_t _alignment;
+	size_t _objectsPerSlab;
+
+	mutable ExclusiveLock _lock;
+	FreeNode* _freeList = nullptr;
+	Stats _stats;
+
+	static inline ExclusiveLock _poolsLock;
+	static inline std::vector<ObjectPool*> _pools;
+};
+
+// inherit from this to allocate the class from its own pool. Allocations of a different size (a further derived class) fall back to the heap
+template <typename T>
+class PoolAllocated
+{
+public:
+	static void* operator new(size_t a_size)
+	{
+		if (a_size != sizeof(T)) {
+			return ::operator new(a_size);
+		}
+
+		return GetPool().Allocate();
+	}
+
+	static void operator delete(void* a_ptr, size_t a_size)
+	{
+		if (!a_ptr) {
+			return;
+		}
+
+		if (a_size != sizeof(T)) {
+			::operator delete(a_ptr);
+			return;
+		}
+
+		GetPool().Deallocate(a_ptr);
+	}
+
+	static ObjectPool& GetPool()
+	{
+		static ObjectPool pool(typeid(T).name(), sizeof(T), alignof(T));
+		return pool;
+	}
+};
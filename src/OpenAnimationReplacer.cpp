@@ -1,6 +1,7 @@
 #include "OpenAnimationReplacer.h"
 
 #include "ActiveClip.h"
+#include "ConditionFactCache.h"
 #include "DetectedProblems.h"
 #include "MergeMapperPluginAPI.h"
 #include "Offsets.h"
@@ -38,8 +39,12 @@ void OpenAnimationReplacer::OnDataLoaded()
 		UI::UIManager::GetSingleton().DisplayWelcomeBanner();
 	}
 
+	BuildKeywordEditorIDMaps();
+
 	CreateReplacerMods();
 
+	ConditionFactCache::GetSingleton().RegisterEventSinks();
+
 	if (Settings::bLoadDefaultBehaviorsInMainMenu && !Settings::bDisablePreloading) {
 		InitDefaultProjects();
 	}
@@ -187,35 +192,36 @@ AnimationReplacements* OpenAnimationReplacer::GetReplacements(RE::hkbCharacter*
 
 ActiveClip* OpenAnimationReplacer::GetActiveClip(RE::hkbClipGenerator* a_clipGenerator) const
 {
-	ReadLocker locker(_activeClipsLock);
+	ActiveClip* result = nullptr;
 
-	if (const auto search = _activeClips.find(a_clipGenerator); search != _activeClips.end()) {
-		return search->second.get();
-	}
+	_activeClips.Visit(a_clipGenerator, [&](const auto& a_activeClip) {
+		result = a_activeClip.get();
+	});
 
-	return nullptr;
+	return result;
 }
 
 std::shared_ptr<ActiveClip> OpenAnimationReplacer::GetActiveClipSharedPtr(RE::hkbClipGenerator* a_clipGenerator) const
 {
-	ReadLocker locker(_activeClipsLock);
+	std::shared_ptr<ActiveClip> result = nullptr;
 
-	if (const auto search = _activeClips.find(a_clipGenerator); search != _activeClips.end()) {
-		return search->second;
-	}
+	_activeClips.Visit(a_clipGenerator, [&](const auto& a_activeClip) {
+		result = a_activeClip;
+	});
 
-	return nullptr;
+	return result;
 }
 
 ActiveClip* OpenAnimationReplacer::GetActiveClipForRefr(RE::TESObjectREFR* a_refr) const
 {
-	ReadLocker locker(_activeClipsLock);
+	if (!a_refr) {
+		return nullptr;
+	}
 
-	if (const auto search = std::ranges::find_if(_activeClips, [&](const auto& pair) {
-			return pair.second->GetRefr() == a_refr;
-		});
-		search != _activeClips.end()) {
-		return search->second.get();
+	ReadLocker locker(_refrIndexLock);
+
+	if (const auto search = _activeClipsByRefr.find(a_refr->GetHandle()); search != _activeClipsByRefr.end() && !search->second.empty()) {
+		return search->second.front();
 	}
 
 	return nullptr;
@@ -223,97 +229,93 @@ ActiveClip* OpenAnimationReplacer::GetActiveClipForRefr(RE::TESObjectREFR* a_ref
 
 ActiveClip* OpenAnimationReplacer::GetActiveClipWithPredicate(std::function<bool(const ActiveClip*)> a_pred) const
 {
-	ReadLocker locker(_activeClipsLock);
+	ActiveClip* result = nullptr;
 
-	if (const auto search = std::ranges::find_if(_activeClips, [&](const auto& pair) {
-			return a_pred(pair.second.get());
-		});
-		search != _activeClips.end()) {
-		return search->second.get();
-	}
+	_activeClips.ForEach([&](const auto&, const auto& a_activeClip) {
+		if (a_pred(a_activeClip.get())) {
+			result = a_activeClip.get();
+			return RE::BSVisit::BSVisitControl::kStop;
+		}
+		return RE::BSVisit::BSVisitControl::kContinue;
+	});
 
-	return nullptr;
+	return result;
 }
 
 std::vector<ActiveClip*> OpenAnimationReplacer::GetActiveClipsForRefr(RE::TESObjectREFR* a_refr) const
 {
-	std::vector<ActiveClip*> results;
+	if (!a_refr) {
+		return {};
+	}
 
-	ReadLocker locker(_activeClipsLock);
+	ReadLocker locker(_refrIndexLock);
 
-	if (const auto search = std::ranges::find_if(_activeClips, [&](const auto& pair) {
-			return pair.second->GetRefr() == a_refr;
-		});
-		search != _activeClips.end()) {
-		results.emplace_back(search->second.get());
+	if (const auto search = _activeClipsByRefr.find(a_refr->GetHandle()); search != _activeClipsByRefr.end()) {
+		return search->second;
 	}
 
-	return results;
+	return {};
 }
 
 ActiveClip* OpenAnimationReplacer::AddOrGetActiveClip(RE::hkbClipGenerator* a_clipGenerator, const RE::hkbContext& a_context, bool& a_bOutAdded)
 {
-	WriteLocker locker(_activeClipsLock);
+	ActiveClip* result = nullptr;
+
+	a_bOutAdded = _activeClips.VisitOrEmplace(
+		a_clipGenerator,
+		[&]() { return std::make_shared<ActiveClip>(a_clipGenerator, a_context.character, a_context.behavior); },
+		[&](const auto& a_activeClip) { result = a_activeClip.get(); });
 
-	auto [newClipIt, result] = _activeClips.try_emplace(a_clipGenerator, nullptr);
-	if (result) {
-		newClipIt->second = std::make_shared<ActiveClip>(a_clipGenerator, a_context.character, a_context.behavior);
+	if (a_bOutAdded) {
+		if (const auto refHandle = result->GetRefHandle()) {
+			WriteLocker locker(_refrIndexLock);
+			_activeClipsByRefr[refHandle].emplace_back(result);
+		}
 	}
 
-	a_bOutAdded = result;
-	return newClipIt->second.get();
+	return result;
 }
 
 void OpenAnimationReplacer::RemoveActiveClip(RE::hkbClipGenerator* a_clipGenerator)
 {
-	std::shared_ptr<ActiveClip> activeClip = nullptr;
-
-	{
-		WriteLocker locker(_activeClipsLock);
-
-		if (const auto search = _activeClips.find(a_clipGenerator); search != _activeClips.end()) {
-			if (!search->second->IsTransitioning()) {
-				activeClip = search->second;  // keep it alive until we release the lock
-				_activeClips.erase(search);
-			}
-		}
+	// the extracted clip is kept alive until it's out of the refr index
+	if (const auto activeClip = _activeClips.ExtractIf(a_clipGenerator, [](const auto& a_activeClip) { return !a_activeClip->IsTransitioning(); })) {
+		RemoveFromRefrIndex(_activeClipsByRefr, activeClip->GetRefHandle(), activeClip.get());
 	}
 }
 
 void OpenAnimationReplacer::ForEachActiveClip(const std::function<void(ActiveClip*)>& a_func) const
 {
-	ReadLocker locker(_activeClipsLock);
-
-	for (auto& activeClip : _activeClips | std::views::values) {
-		a_func(activeClip.get());
-	}
+	_activeClips.ForEach([&](const auto&, const auto& a_activeClip) {
+		a_func(a_activeClip.get());
+		return RE::BSVisit::BSVisitControl::kContinue;
+	});
 }
 
 void OpenAnimationReplacer::OnActiveClipLoopOrEcho(ActiveClip* a_activeClip, bool a_bIsEcho)
 {
-	const auto refr = a_activeClip->GetRefr();
+	const auto refHandle = a_activeClip->GetRefHandle();
 
-	WriteLocker locker(_stateDataLock);
+	// shared lock, holders that end up empty are unregistered on the next state data update instead
+	ReadLocker locker(_stateDataLock);
 
-	for (auto it = _registeredStateDatas.begin(); it != _registeredStateDatas.end();) {
-		const auto registeredStateDataContainer = *it;
-		if (!registeredStateDataContainer->StateDataOnLoopOrEcho(refr->GetHandle(), a_activeClip, a_bIsEcho)) {
-			it = _registeredStateDatas.erase(it);
-		} else {
-			++it;
+	if (const auto search = _stateDataHoldersByRefr.find(refHandle); search != _stateDataHoldersByRefr.end()) {
+		for (const auto registeredStateDataContainer : search->second) {
+			std::ignore = registeredStateDataContainer->StateDataOnLoopOrEcho(refHandle, a_activeClip, a_bIsEcho);
 		}
 	}
 }
 
 ActiveSynchronizedAnimation* OpenAnimationReplacer::GetActiveSynchronizedAnimationForRefr(RE::TESObjectREFR* a_refr) const
 {
-	ReadLocker locker(_activeSynchronizedAnimationsLock);
+	if (!a_refr) {
+		return nullptr;
+	}
 
-	if (const auto search = std::ranges::find_if(_activeSynchronizedAnimations, [&](const auto& pair) {
-			return pair.second->HasRef(a_refr);
-		});
-		search != _activeSynchronizedAnimations.end()) {
-		return search->second.get();
+	ReadLocker locker(_refrIndexLock);
+
+	if (const auto search = _activeSynchronizedAnimationsByRefr.find(a_refr->GetHandle()); search != _activeSynchronizedAnimationsByRefr.end() && !search->second.empty()) {
+		return search->second.front();
 	}
 
 	return nullptr;
@@ -321,66 +323,72 @@ ActiveSynchronizedAnimation* OpenAnimationReplacer::GetActiveSynchronizedAnimati
 
 ActiveSynchronizedAnimation* OpenAnimationReplacer::AddOrGetActiveSynchronizedAnimation(RE::BGSSynchronizedAnimationInstance* a_synchronizedAnimationInstance)
 {
-	WriteLocker locker(_activeSynchronizedAnimationsLock);
+	ActiveSynchronizedAnimation* result = nullptr;
 
-	auto [newClipIt, result] = _activeSynchronizedAnimations.try_emplace(a_synchronizedAnimationInstance, nullptr);
-	if (result) {
-		newClipIt->second = std::make_unique<ActiveSynchronizedAnimation>(a_synchronizedAnimationInstance);
+	const bool bAdded = _activeSynchronizedAnimations.VisitOrEmplace(
+		a_synchronizedAnimationInstance,
+		[&]() { return std::make_unique<ActiveSynchronizedAnimation>(a_synchronizedAnimationInstance); },
+		[&](const auto& a_activeSynchronizedAnimation) { result = a_activeSynchronizedAnimation.get(); });
+
+	if (bAdded) {
+		WriteLocker locker(_refrIndexLock);
+		for (const auto& refHandle : a_synchronizedAnimationInstance->refHandles) {
+			if (refHandle) {
+				_activeSynchronizedAnimationsByRefr[refHandle].emplace_back(result);
+			}
+		}
 	}
 
-	return newClipIt->second.get();
+	return result;
 }
 
 ActiveSynchronizedAnimation* OpenAnimationReplacer::GetActiveSynchronizedAnimation(RE::BGSSynchronizedAnimationInstance* a_synchronizedAnimationInstance)
 {
-	ReadLocker locker(_activeSynchronizedAnimationsLock);
+	ActiveSynchronizedAnimation* result = nullptr;
 
-	if (const auto search = _activeSynchronizedAnimations.find(a_synchronizedAnimationInstance); search != _activeSynchronizedAnimations.end()) {
-		return search->second.get();
-	}
+	_activeSynchronizedAnimations.Visit(a_synchronizedAnimationInstance, [&](const auto& a_activeSynchronizedAnimation) {
+		result = a_activeSynchronizedAnimation.get();
+	});
 
-	return nullptr;
+	return result;
 }
 
 void OpenAnimationReplacer::RemoveActiveSynchronizedAnimation(RE::BGSSynchronizedAnimationInstance* a_synchronizedAnimationInstance)
 {
-	WriteLocker locker(_activeSynchronizedAnimationsLock);
+	if (const auto activeSynchronizedAnimation = GetActiveSynchronizedAnimation(a_synchronizedAnimationInstance)) {
+		for (const auto& refHandle : a_synchronizedAnimationInstance->refHandles) {
+			RemoveFromRefrIndex(_activeSynchronizedAnimationsByRefr, refHandle, activeSynchronizedAnimation);
+		}
+	}
 
-	_activeSynchronizedAnimations.erase(a_synchronizedAnimationInstance);
+	_activeSynchronizedAnimations.Erase(a_synchronizedAnimationInstance);
 }
 
 void OpenAnimationReplacer::OnSynchronizedClipPreUpdate(RE::BSSynchronizedClipGenerator* a_synchronizedClipGenerator, const RE::hkbContext& a_context, float a_timestep)
 {
-	ReadLocker locker(_activeSynchronizedAnimationsLock);
-
 	if (const auto synchronizedAnimationInstance = a_synchronizedClipGenerator->synchronizedScene) {
-		if (const auto search = _activeSynchronizedAnimations.find(synchronizedAnimationInstance); search != _activeSynchronizedAnimations.end()) {
-			search->second->OnSynchronizedClipPreUpdate(a_synchronizedClipGenerator, a_context, a_timestep);
-		}
+		_activeSynchronizedAnimations.Visit(synchronizedAnimationInstance, [&](const auto& a_activeSynchronizedAnimation) {
+			a_activeSynchronizedAnimation->OnSynchronizedClipPreUpdate(a_synchronizedClipGenerator, a_context, a_timestep);
+		});
 	}
 }
 
 void OpenAnimationReplacer::OnSynchronizedClipPostUpdate(RE::BSSynchronizedClipGenerator* a_synchronizedClipGenerator, const RE::hkbContext& a_context, float a_timestep)
 {
-	ReadLocker locker(_activeSynchronizedAnimationsLock);
-
 	if (const auto synchronizedAnimationInstance = a_synchronizedClipGenerator->synchronizedScene) {
-		if (const auto search = _activeSynchronizedAnimations.find(synchronizedAnimationInstance); search != _activeSynchronizedAnimations.end()) {
-			search->second->OnSynchronizedClipPostUpdate(a_synchronizedClipGenerator, a_context, a_timestep);
-		}
+		_activeSynchronizedAnimations.Visit(synchronizedAnimationInstance, [&](const auto& a_activeSynchronizedAnimation) {
+			a_activeSynchronizedAnimation->OnSynchronizedClipPostUpdate(a_synchronizedClipGenerator, a_context, a_timestep);
+		});
 	}
 }
 
 void OpenAnimationReplacer::OnSynchronizedClipDeactivate(RE::BSSynchronizedClipGenerator* a_synchronizedClipGenerator, const RE::hkbContext& a_context)
 {
-	{
-		ReadLocker locker(_activeSynchronizedAnimationsLock);
-		if (const auto synchronizedAnimationInstance = a_synchronizedClipGenerator->synchronizedScene) {
-			if (const auto search = _activeSynchronizedAnimations.find(synchronizedAnimationInstance); search != _activeSynchronizedAnimations.end()) {
-				search->second->OnSynchronizedClipDeactivate(a_synchronizedClipGenerator, a_context);
-
-				return;
-			}
+	if (const auto synchronizedAnimationInstance = a_synchronizedClipGenerator->synchronizedScene) {
+		if (_activeSynchronizedAnimations.Visit(synchronizedAnimationInstance, [&](const auto& a_activeSynchronizedAnimation) {
+				a_activeSynchronizedAnimation->OnSynchronizedClipDeactivate(a_synchronizedClipGenerator, a_context);
+			})) {
+			return;
 		}
 	}
 
@@ -392,57 +400,51 @@ void OpenAnimationReplacer::OnSynchronizedClipDeactivate(RE::BSSynchronizedClipG
 
 ActiveScenelessSynchronizedClip* OpenAnimationReplacer::GetActiveScenelessSynchronizedClip(RE::BSSynchronizedClipGenerator* a_synchronizedClipGenerator, [[maybe_unused]] const RE::hkbContext& a_context) const
 {
-	ReadLocker locker(_activeSynchronizedAnimationsLock);
+	ActiveScenelessSynchronizedClip* result = nullptr;
 
-	if (const auto search = _activeScenelessSynchronizedClips.find(a_synchronizedClipGenerator); search != _activeScenelessSynchronizedClips.end()) {
-		return search->second.get();
-	}
+	_activeScenelessSynchronizedClips.Visit(a_synchronizedClipGenerator, [&](const auto& a_scenelessClip) {
+		result = a_scenelessClip.get();
+	});
 
-	return nullptr;
+	return result;
 }
 
 ActiveScenelessSynchronizedClip* OpenAnimationReplacer::AddOrGetActiveScenelessSynchronizedClip(RE::BSSynchronizedClipGenerator* a_synchronizedClipGenerator, [[maybe_unused]] const RE::hkbContext& a_context)
 {
-	WriteLocker locker(_activeSynchronizedAnimationsLock);
+	ActiveScenelessSynchronizedClip* result = nullptr;
 
-	auto [newClipIt, result] = _activeScenelessSynchronizedClips.try_emplace(a_synchronizedClipGenerator, nullptr);
-	if (result) {
-		newClipIt->second = std::make_unique<ActiveScenelessSynchronizedClip>(a_synchronizedClipGenerator);
-	}
+	_activeScenelessSynchronizedClips.VisitOrEmplace(
+		a_synchronizedClipGenerator,
+		[&]() { return std::make_unique<ActiveScenelessSynchronizedClip>(a_synchronizedClipGenerator); },
+		[&](const auto& a_scenelessClip) { result = a_scenelessClip.get(); });
 
-	return newClipIt->second.get();
+	return result;
 }
 
 void OpenAnimationReplacer::RemoveScenelessSynchronizedClip(RE::BSSynchronizedClipGenerator* a_synchronizedClipGenerator)
 {
-	WriteLocker locker(_activeSynchronizedAnimationsLock);
-
-	_activeScenelessSynchronizedClips.erase(a_synchronizedClipGenerator);
+	_activeScenelessSynchronizedClips.Erase(a_synchronizedClipGenerator);
 }
 
 ActiveAnimationPreview* OpenAnimationReplacer::GetActiveAnimationPreview(RE::hkbBehaviorGraph* a_behaviorGraph) const
 {
-	ReadLocker locker(_activeAnimationPreviewsLock);
+	ActiveAnimationPreview* result = nullptr;
 
-	if (const auto search = _activeAnimationPreviews.find(a_behaviorGraph); search != _activeAnimationPreviews.end()) {
-		return search->second.get();
-	}
+	_activeAnimationPreviews.Visit(a_behaviorGraph, [&](const auto& a_activeAnimationPreview) {
+		result = a_activeAnimationPreview.get();
+	});
 
-	return nullptr;
+	return result;
 }
 
 void OpenAnimationReplacer::AddActiveAnimationPreview(RE::hkbBehaviorGraph* a_behaviorGraph, const ReplacementAnimation* a_replacementAnimation, std::string_view a_syncAnimationPrefix, Variant* a_variant)
 {
-	WriteLocker locker(_activeAnimationPreviewsLock);
-
-	_activeAnimationPreviews[a_behaviorGraph] = std::make_unique<ActiveAnimationPreview>(a_behaviorGraph, a_replacementAnimation, a_syncAnimationPrefix, a_variant);
+	_activeAnimationPreviews.InsertOrAssign(a_behaviorGraph, std::make_unique<ActiveAnimationPreview>(a_behaviorGraph, a_replacementAnimation, a_syncAnimationPrefix, a_variant));
 }
 
 void OpenAnimationReplacer::RemoveActiveAnimationPreview(RE::hkbBehaviorGraph* a_behaviorGraph)
 {
-	WriteLocker locker(_activeAnimationPreviewsLock);
-
-	_activeAnimationPreviews.erase(a_behaviorGraph);
+	_activeAnimationPreviews.Erase(a_behaviorGraph);
 }
 
 bool OpenAnimationReplacer::IsOriginalAnimationInterruptible(RE::hkbCharacter* a_character, uint16_t a_originalIndex) const
@@ -475,6 +477,17 @@ bool OpenAnimationReplacer::ShouldOriginalAnimationReplaceOnEcho(RE::hkbCharacte
 	return false;
 }
 
+void OpenAnimationReplacer::BuildKeywordEditorIDMaps()
+{
+	const auto startTime = std::chrono::high_resolution_clock::now();
+
+	Conditions::KeywordEditorIDMap<RE::BGSKeyword>::Build();
+	Conditions::KeywordEditorIDMap<RE::BGSLocationRefType>::Build();
+
+	const auto endTime = std::chrono::high_resolution_clock::now();
+	logger::info("Built keyword editor ID maps in {}ms", std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count());
+}
+
 void OpenAnimationReplacer::CreateReplacerMods()
 {
 	logger::info("Creating replacer mods...");
@@ -769,6 +782,20 @@ void OpenAnimationReplacer::UnloadAnimation(RE::hkbCharacter* a_character, uint1
 	RE::AnimationFileManagerSingleton::GetSingleton()->Unload(*reinterpret_cast<RE::hkbContext*>(&a_character), clipGenerator, nullptr);
 }
 
+bool OpenAnimationReplacer::IsAnimationLoaded(RE::hkbCharacter* a_character, uint16_t a_animationIndex)
+{
+	// the binding is only filled in by the animation file manager once the file has been loaded
+	if (const RE::hkbAnimationBindingSet* bindingSet = hkbCharacter_GetAnimationBindingSet(a_character)) {
+		if (a_animationIndex < bindingSet->bindings.size()) {
+			if (const auto& bindingWithTriggers = bindingSet->bindings[a_animationIndex]) {
+				return bindingWithTriggers->binding && bindingWithTriggers->binding->animation;
+			}
+		}
+	}
+
+	return false;
+}
+
 void OpenAnimationReplacer::InitFactories()
 {
 	using namespace Conditions;
@@ -928,6 +955,14 @@ void OpenAnimationReplacer::InitFactories()
 		_conditionFactories.emplace(name, [&]() { return std::unique_ptr<ICondition>(factory()); });
 	}
 
+	// intern the known condition names up front, anything else (e.g. names that differ from their factory name) gets interned on first use
+	for (const auto& name : _conditionFactories | std::views::keys) {
+		std::ignore = GetConditionNameID(name);
+	}
+	for (const auto& name : _hiddenConditionFactories | std::views::keys) {
+		std::ignore = GetConditionNameID(name);
+	}
+
 	_bFactoriesInitialized = true;
 
 	logger::info("Condition factories initialized.");
@@ -1017,7 +1052,50 @@ bool OpenAnimationReplacer::IsCustomCondition(std::string_view a_conditionName)
 	return _customConditionFactories.contains(a_conditionName.data());
 }
 
-Conditions::IStateData* OpenAnimationReplacer::GetConditionStateData(const Conditions::IConditionStateComponent* a_conditionStateComponent, RE::TESObjectREFR* a_refr, RE::hkbClipGenerator* a_clipGenerator, void* a_parentSubMod)
+uint32_t OpenAnimationReplacer::GetConditionNameID(std::string_view a_conditionName)
+{
+	{
+		ReadLocker locker(_conditionNameIDsLock);
+		if (const auto it = _conditionNameIDs.find(a_conditionName); it != _conditionNameIDs.end()) {
+			return it->second;
+		}
+	}
+
+	WriteLocker locker(_conditionNameIDsLock);
+	// IDs start at 1, 0 means not interned yet
+	return _conditionNameIDs.try_emplace(std::string(a_conditionName), static_cast<uint32_t>(_conditionNameIDs.size() + 1)).first->second;
+}
+
+uint32_t OpenAnimationReplacer::GetClipNameID(std::string_view a_clipName)
+{
+	{
+		ReadLocker locker(_clipNameIDsLock);
+		if (const auto it = _clipNameIDs.find(a_clipName); it != _clipNameIDs.end()) {
+			return it->second;
+		}
+	}
+
+	WriteLocker locker(_clipNameIDsLock);
+	const auto [it, bInserted] = _clipNameIDs.try_emplace(std::string(a_clipName), static_cast<uint32_t>(_clipNameIDs.size() + 1));
+	if (bInserted) {
+		_clipNames.emplace_back(&it->first);
+	}
+
+	return it->second;
+}
+
+std::string_view OpenAnimationReplacer::GetClipName(uint32_t a_clipNameID) const
+{
+	ReadLocker locker(_clipNameIDsLock);
+
+	if (a_clipNameID > 0 && a_clipNameID <= _clipNames.size()) {
+		return *_clipNames[a_clipNameID - 1];
+	}
+
+	return ""sv;
+}
+
+Conditions::IStateData* OpenAnimationReplacer::GetConditionStateData(const Conditions::ConditionStateComponent* a_conditionStateComponent, RE::TESObjectREFR* a_refr, RE::hkbClipGenerator* a_clipGenerator, void* a_parentSubMod)
 {
 	if (a_refr) {
 		switch (a_conditionStateComponent->GetStateDataScope()) {
@@ -1038,27 +1116,31 @@ Conditions::IStateData* OpenAnimationReplacer::GetConditionStateData(const Condi
 			if (a_parentSubMod) {
 				const auto parentSubMod = static_cast<SubMod*>(a_parentSubMod);
 				if (const auto parentReplacerMod = parentSubMod->GetParentMod()) {
-					return parentReplacerMod->conditionStateData.AccessStateData({ a_refr->GetHandle(), std::string(a_conditionStateComponent->GetParentCondition()->GetName()) }, a_clipGenerator);
+					return parentReplacerMod->conditionStateData.AccessStateData({ a_refr->GetHandle(), a_conditionStateComponent->GetConditionNameID() }, a_clipGenerator);
 				}
 			}
 			break;
 		case Conditions::StateDataScope::kReference:
-			return _conditionStateData.AccessStateData({ a_refr->GetHandle(), std::string(a_conditionStateComponent->GetParentCondition()->GetName()) }, a_clipGenerator);
+			return _conditionStateData.AccessStateData({ a_refr->GetHandle(), a_conditionStateComponent->GetConditionNameID() }, a_clipGenerator);
 		}
 	}
 
 	return nullptr;
 }
 
-Conditions::IStateData* OpenAnimationReplacer::AddConditionStateData(Conditions::IStateData* a_conditionStateData, const Conditions::IConditionStateComponent* a_conditionStateComponent, RE::TESObjectREFR* a_refr, RE::hkbClipGenerator* a_clipGenerator, void* a_parentSubMod)
+Conditions::IStateData* OpenAnimationReplacer::AddConditionStateData(Conditions::IStateData* a_conditionStateData, const Conditions::ConditionStateComponent* a_conditionStateComponent, RE::TESObjectREFR* a_refr, RE::hkbClipGenerator* a_clipGenerator, void* a_parentSubMod)
 {
 	if (a_refr) {
+		// custom conditions can't tell us whether their state data needs ticking, so assume it does
+		const auto parentCondition = a_conditionStateComponent->GetParentCondition();
+		const bool bTicking = parentCondition->GetConditionType() == Conditions::ConditionType::kCustom || static_cast<const Conditions::ConditionBase*>(parentCondition)->HasTickingStateData();
+
 		switch (a_conditionStateComponent->GetStateDataScope()) {
 		case Conditions::StateDataScope::kLocal:
 			if (a_clipGenerator) {
 				if (const auto activeClip = GetActiveClip(a_clipGenerator)) {
-					if (const auto stateData = activeClip->conditionStateData.AddStateData({ a_refr->GetHandle(), a_conditionStateComponent->GetParentCondition() }, a_conditionStateData, a_clipGenerator)) {
-						activeClip->RegisterStateDataContainer();
+					if (const auto stateData = activeClip->conditionStateData.AddStateData({ a_refr->GetHandle(), a_conditionStateComponent->GetParentCondition() }, a_conditionStateData, a_clipGenerator, bTicking)) {
+						activeClip->RegisterStateDataContainer(a_refr->GetHandle());
 						return stateData;
 					}
 				}
@@ -1067,8 +1149,8 @@ Conditions::IStateData* OpenAnimationReplacer::AddConditionStateData(Conditions:
 		case Conditions::StateDataScope::kSubMod:
 			if (a_parentSubMod) {
 				const auto parentSubMod = static_cast<SubMod*>(a_parentSubMod);
-				if (const auto stateData = parentSubMod->conditionStateData.AddStateData({ a_refr->GetHandle(), a_conditionStateComponent->GetParentCondition() }, a_conditionStateData, a_clipGenerator)) {
-					parentSubMod->RegisterStateDataContainer();
+				if (const auto stateData = parentSubMod->conditionStateData.AddStateData({ a_refr->GetHandle(), a_conditionStateComponent->GetParentCondition() }, a_conditionStateData, a_clipGenerator, bTicking)) {
+					parentSubMod->RegisterStateDataContainer(a_refr->GetHandle());
 					return stateData;
 				}
 			}
@@ -1077,16 +1159,16 @@ Conditions::IStateData* OpenAnimationReplacer::AddConditionStateData(Conditions:
 			if (a_parentSubMod) {
 				const auto parentSubMod = static_cast<SubMod*>(a_parentSubMod);
 				if (const auto parentReplacerMod = parentSubMod->GetParentMod()) {
-					if (const auto stateData = parentReplacerMod->conditionStateData.AddStateData({ a_refr->GetHandle(), std::string(a_conditionStateComponent->GetParentCondition()->GetName()) }, a_conditionStateData, a_clipGenerator)) {
-						parentReplacerMod->RegisterStateDataContainer();
+					if (const auto stateData = parentReplacerMod->conditionStateData.AddStateData({ a_refr->GetHandle(), a_conditionStateComponent->GetConditionNameID() }, a_conditionStateData, a_clipGenerator, bTicking)) {
+						parentReplacerMod->RegisterStateDataContainer(a_refr->GetHandle());
 						return stateData;
 					}
 				}
 			}
 			break;
 		case Conditions::StateDataScope::kReference:
-			if (const auto stateData = _conditionStateData.AddStateData({ a_refr->GetHandle(), std::string(a_conditionStateComponent->GetParentCondition()->GetName()) }, a_conditionStateData, a_clipGenerator)) {
-				RegisterStateDataContainer();
+			if (const auto stateData = _conditionStateData.AddStateData({ a_refr->GetHandle(), a_conditionStateComponent->GetConditionNameID() }, a_conditionStateData, a_clipGenerator, bTicking)) {
+				RegisterStateDataContainer(a_refr->GetHandle());
 				return stateData;
 			}
 		}
@@ -1106,7 +1188,7 @@ VariantStateData* OpenAnimationReplacer::AddVariantStateData(VariantStateData* a
 	const auto refHandle = a_refr->GetHandle();
 	if (const auto replacerMod = a_variants->GetParentSubMod()->GetParentMod()) {
 		if (const auto stateData = replacerMod->variantStateData.AddStateData(refHandle, a_variantStateData, a_activeClip->GetClipGenerator(), a_variants)) {
-			replacerMod->RegisterStateDataContainer();
+			replacerMod->RegisterStateDataContainer(refHandle);
 			return static_cast<VariantStateData*>(stateData);
 		}
 	}
@@ -1116,14 +1198,19 @@ VariantStateData* OpenAnimationReplacer::AddVariantStateData(VariantStateData* a
 
 void OpenAnimationReplacer::ClearConditionStateDataForRefr(RE::TESObjectREFR* a_refr)
 {
+	const auto refHandle = a_refr->GetHandle();
+
 	WriteLocker locker(_stateDataLock);
 
-	for (auto it = _registeredStateDatas.begin(); it != _registeredStateDatas.end();) {
-		const auto registeredStateDataContainer = *it;
-		if (!registeredStateDataContainer->StateDataClearRefrData(a_refr->GetHandle())) {
-			it = _registeredStateDatas.erase(it);
-		} else {
-			++it;
+	if (auto holdersNode = _stateDataHoldersByRefr.extract(refHandle)) {
+		for (const auto registeredStateDataContainer : holdersNode.mapped()) {
+			if (const auto search = _stateDataRefrsByHolder.find(registeredStateDataContainer); search != _stateDataRefrsByHolder.end()) {
+				search->second.erase(refHandle);
+			}
+
+			if (!registeredStateDataContainer->StateDataClearRefrData(refHandle)) {
+				EraseRegisteredStateData(registeredStateDataContainer);
+			}
 		}
 	}
 }
@@ -1137,6 +1224,8 @@ void OpenAnimationReplacer::ClearAllConditionStateData()
 	}
 
 	_registeredStateDatas.clear();
+	_stateDataHoldersByRefr.clear();
+	_stateDataRefrsByHolder.clear();
 }
 
 void OpenAnimationReplacer::LoadKeywords() const
@@ -1180,32 +1269,77 @@ void OpenAnimationReplacer::RunJobs()
 	//}
 }
 
-void OpenAnimationReplacer::RegisterStateData(IStateDataContainerHolder* a_obj)
+void OpenAnimationReplacer::RegisterStateData(IStateDataContainerHolder* a_obj, RE::ObjectRefHandle a_refHandle)
 {
 	WriteLocker locker(_stateDataLock);
 
 	_registeredStateDatas.emplace(a_obj);
+	_stateDataHoldersByRefr[a_refHandle].emplace(a_obj);
+	_stateDataRefrsByHolder[a_obj].emplace(a_refHandle);
 }
 
 void OpenAnimationReplacer::UnregisterStateData(IStateDataContainerHolder* a_obj)
 {
 	WriteLocker locker(_stateDataLock);
 
+	EraseRegisteredStateData(a_obj);
+}
+
+void OpenAnimationReplacer::EraseRegisteredStateData(IStateDataContainerHolder* a_obj)
+{
 	_registeredStateDatas.erase(a_obj);
+
+	if (auto refrsNode = _stateDataRefrsByHolder.extract(a_obj)) {
+		for (const auto& refHandle : refrsNode.mapped()) {
+			if (const auto search = _stateDataHoldersByRefr.find(refHandle); search != _stateDataHoldersByRefr.end()) {
+				search->second.erase(a_obj);
+				if (search->second.empty()) {
+					_stateDataHoldersByRefr.erase(search);
+				}
+			}
+		}
+	}
+}
+
+void OpenAnimationReplacer::EraseRegisteredStateDataRefr(IStateDataContainerHolder* a_obj, RE::ObjectRefHandle a_refHandle)
+{
+	if (const auto search = _stateDataHoldersByRefr.find(a_refHandle); search != _stateDataHoldersByRefr.end()) {
+		search->second.erase(a_obj);
+		if (search->second.empty()) {
+			_stateDataHoldersByRefr.erase(search);
+		}
+	}
+
+	if (const auto search = _stateDataRefrsByHolder.find(a_obj); search != _stateDataRefrsByHolder.end()) {
+		search->second.erase(a_refHandle);
+		if (search->second.empty()) {
+			_stateDataRefrsByHolder.erase(search);
+		}
+	}
 }
 
 void OpenAnimationReplacer::RunStateDataUpdates()
 {
 	WriteLocker locker(_stateDataLock);
 
-	for (auto it = _registeredStateDatas.begin(); it != _registeredStateDatas.end();) {
-		const auto registeredStateDataContainer = *it;
+	StateDataContainerEntry::AdvanceStateDataTime(g_deltaTime);
+
+	std::vector<IStateDataContainerHolder*> emptyHolders;
+
+	for (const auto registeredStateDataContainer : _registeredStateDatas) {
 		if (!registeredStateDataContainer->StateDataUpdate(g_deltaTime)) {
-			it = _registeredStateDatas.erase(it);
+			emptyHolders.emplace_back(registeredStateDataContainer);
 		} else {
-			++it;
+			// the holder still has data, but its entries for some refs might have expired since the last update
+			for (const auto& refHandle : registeredStateDataContainer->TakeExpiredStateDataRefrs()) {
+				EraseRegisteredStateDataRefr(registeredStateDataContainer, refHandle);
+			}
 		}
 	}
+
+	for (const auto registeredStateDataContainer : emptyHolders) {
+		EraseRegisteredStateData(registeredStateDataContainer);
+	}
 }
 
 void OpenAnimationReplacer::ForEachRegisteredStateData(std::function<void(IStateDataContainerHolder*)> a_func) const
@@ -5,6 +5,7 @@
 #include "ActiveSynchronizedAnimation.h"
 #include "Jobs.h"
 #include "ReplacerMods.h"
+#include "ShardedMap.h"
 
 #include <unordered_set>
 
@@ -62,7 +63,7 @@ public:
 	ActiveScenelessSynchronizedClip* AddOrGetActiveScenelessSynchronizedClip(RE::BSSynchronizedClipGenerator* a_synchronizedClipGenerator, const RE::hkbContext& a_context);
 	void RemoveScenelessSynchronizedClip(RE::BSSynchronizedClipGenerator* a_synchronizedClipGenerator);
 
-	[[nodiscard]] bool HasActiveAnimationPreviews() const { return !_activeAnimationPreviews.empty(); }
+	[[nodiscard]] bool HasActiveAnimationPreviews() const { return !_activeAnimationPreviews.Empty(); }
 	[[nodiscard]] ActiveAnimationPreview* GetActiveAnimationPreview(RE::hkbBehaviorGraph* a_behaviorGraph) const;
 	void AddActiveAnimationPreview(RE::hkbBehaviorGraph* a_behaviorGraph, const ReplacementAnimation* a_replacementAnimation, std::string_view a_syncAnimationPrefix, Variant* a_variant = nullptr);
 	void RemoveActiveAnimationPreview(RE::hkbBehaviorGraph* a_behaviorGraph);
@@ -70,6 +71,7 @@ public:
 	[[nodiscard]] bool IsOriginalAnimationInterruptible(RE::hkbCharacter* a_character, uint16_t a_originalIndex) const;
 	[[nodiscard]] bool ShouldOriginalAnimationReplaceOnEcho(RE::hkbCharacter* a_character, uint16_t a_originalIndex) const;
 
+	void BuildKeywordEditorIDMaps();
 	void CreateReplacerMods();
 	void CreateReplacementAnimations(const char* a_path, RE::hkbCharacterStringData* a_stringData, RE::BShkbHkxDB::ProjectDBData* a_projectDBData);
 
@@ -89,6 +91,7 @@ public:
 
 	static void LoadAnimation(RE::hkbCharacter* a_character, uint16_t a_animationIndex);
 	static void UnloadAnimation(RE::hkbCharacter* a_character, uint16_t a_animationIndex);
+	[[nodiscard]] static bool IsAnimationLoaded(RE::hkbCharacter* a_character, uint16_t a_animationIndex);
 
 	[[nodiscard]] bool AreFactoriesInitialized() const { return _bFactoriesInitialized; }
 	void InitFactories();
@@ -101,8 +104,14 @@ public:
 	OAR_API::Conditions::APIResult AddCustomCondition(std::string_view a_pluginName, REL::Version a_pluginVersion, std::string_view a_conditionName, Conditions::ConditionFactory a_conditionFactory);
 	bool IsCustomCondition(std::string_view a_conditionName) const;
 
-	[[nodiscard]] Conditions::IStateData* GetConditionStateData(const Conditions::IConditionStateComponent* a_conditionStateComponent, RE::TESObjectREFR* a_refr, RE::hkbClipGenerator* a_clipGenerator, void* a_parentSubMod);
-	[[nodiscard]] Conditions::IStateData* AddConditionStateData(Conditions::IStateData* a_conditionStateData, const Conditions::IConditionStateComponent* a_conditionStateComponent, RE::TESObjectREFR* a_refr, RE::hkbClipGenerator* a_clipGenerator, void* a_parentSubMod);
+	[[nodiscard]] Conditions::IStateData* GetConditionStateData(const Conditions::ConditionStateComponent* a_conditionStateComponent, RE::TESObjectREFR* a_refr, RE::hkbClipGenerator* a_clipGenerator, void* a_parentSubMod);
+	[[nodiscard]] Conditions::IStateData* AddConditionStateData(Conditions::IStateData* a_conditionStateData, const Conditions::ConditionStateComponent* a_conditionStateComponent, RE::TESObjectREFR* a_refr, RE::hkbClipGenerator* a_clipGenerator, void* a_parentSubMod);
+
+	// condition names are interned to small integer IDs, used as the state data keys for the shared scopes
+	[[nodiscard]] uint32_t GetConditionNameID(std::string_view a_conditionName);
+	// clip generator names are interned the same way, used as the keys of the per clip variant state
+	[[nodiscard]] uint32_t GetClipNameID(std::string_view a_clipName);
+	[[nodiscard]] std::string_view GetClipName(uint32_t a_clipNameID) const;
 	[[nodiscard]] VariantStateData* GetVariantStateData(RE::TESObjectREFR* a_refr, const Variants* a_variants, ActiveClip* a_activeClip) const;
 	[[nodiscard]] VariantStateData* AddVariantStateData(VariantStateData* a_variantStateData, RE::TESObjectREFR* a_refr, const Variants* a_variants, ActiveClip* a_activeClip);
 
@@ -136,7 +145,7 @@ public:
 		_weakLatentJobs.emplace_back(a_job);
 	}
 
-	void RegisterStateData(IStateDataContainerHolder* a_obj);
+	void RegisterStateData(IStateDataContainerHolder* a_obj, RE::ObjectRefHandle a_refHandle);
 	void UnregisterStateData(IStateDataContainerHolder* a_obj);
 	void RunStateDataUpdates();
 	void ForEachRegisteredStateData(std::function<void(IStateDataContainerHolder*)> a_func) const;
@@ -165,20 +174,35 @@ protected:
 	mutable SharedLock _replacerModNameLock;
 	std::unordered_map<std::string, ReplacerMod*> _replacerModNameMap;
 
-	mutable SharedLock _activeClipsLock;
-	std::unordered_map<RE::hkbClipGenerator*, std::shared_ptr<ActiveClip>> _activeClips;
+	// sharded by clip generator so behavior graph updates on different threads don't contend on a single lock
+	ShardedMap<RE::hkbClipGenerator*, std::shared_ptr<ActiveClip>> _activeClips;
+	ShardedMap<RE::BGSSynchronizedAnimationInstance*, std::unique_ptr<ActiveSynchronizedAnimation>> _activeSynchronizedAnimations;
+	ShardedMap<RE::BSSynchronizedClipGenerator*, std::unique_ptr<ActiveScenelessSynchronizedClip>> _activeScenelessSynchronizedClips;
+
+	// active clips and synchronized animations indexed by the reference they belong to, kept up to date on add and remove
+	template <typename T>
+	void RemoveFromRefrIndex(std::unordered_map<RE::ObjectRefHandle, std::vector<T*>>& a_index, RE::ObjectRefHandle a_refHandle, T* a_value)
+	{
+		WriteLocker locker(_refrIndexLock);
+
+		if (const auto search = a_index.find(a_refHandle); search != a_index.end()) {
+			std::erase(search->second, a_value);
+			if (search->second.empty()) {
+				a_index.erase(search);
+			}
+		}
+	}
 
-	mutable SharedLock _activeSynchronizedAnimationsLock;
-	std::unordered_map<RE::BGSSynchronizedAnimationInstance*, std::unique_ptr<ActiveSynchronizedAnimation>> _activeSynchronizedAnimations;
-	std::unordered_map<RE::BSSynchronizedClipGenerator*, std::unique_ptr<ActiveScenelessSynchronizedClip>> _activeScenelessSynchronizedClips;
+	mutable SharedLock _refrIndexLock;
+	std::unordered_map<RE::ObjectRefHandle, std::vector<ActiveClip*>> _activeClipsByRefr;
+	std::unordered_map<RE::ObjectRefHandle, std::vector<ActiveSynchronizedAnimation*>> _activeSynchronizedAnimationsByRefr;
 
 	// For clips that are part of a synchronized animation where one of the involved animations is replaced and wants non annotation triggers removed.
 	// Solves the issue where vanilla triggers from first person killmoves have effect while third person animations are replaced.
 	mutable SharedLock _clipsPendingNonAnnotationTriggersRemovalLock;
 	std::unordered_set<RE::hkbClipGenerator*> _clipsPendingNonAnnotationTriggersRemoval;
 
-	mutable SharedLock _activeAnimationPreviewsLock;
-	std::unordered_map<RE::hkbBehaviorGraph*, std::unique_ptr<ActiveAnimationPreview>> _activeAnimationPreviews;
+	ShardedMap<RE::hkbBehaviorGraph*, std::unique_ptr<ActiveAnimationPreview>> _activeAnimationPreviews;
 
 	void InitDefaultProjects() const;
 	[[nodiscard]] RE::Character* CreateDummyCharacter(RE::TESNPC* a_baseForm) const;
@@ -205,7 +229,22 @@ protected:
 	mutable SharedLock _stateDataLock;
 	std::set<IStateDataContainerHolder*> _registeredStateDatas;
 
-	StateDataContainer<std::string> _conditionStateData;
+	// which holders store state data for which references, so loop/echo and clear notifications only go to the holders that are relevant
+	std::unordered_map<RE::ObjectRefHandle, std::unordered_set<IStateDataContainerHolder*>> _stateDataHoldersByRefr;
+	std::unordered_map<IStateDataContainerHolder*, std::unordered_set<RE::ObjectRefHandle>> _stateDataRefrsByHolder;
+
+	void EraseRegisteredStateData(IStateDataContainerHolder* a_obj);
+	void EraseRegisteredStateDataRefr(IStateDataContainerHolder* a_obj, RE::ObjectRefHandle a_refHandle);
+
+	mutable SharedLock _conditionNameIDsLock;
+	std::unordered_map<std::string, uint32_t, KeyHash<std::string>, KeyEqual<std::string>> _conditionNameIDs;
+
+	mutable SharedLock _clipNameIDsLock;
+	std::unordered_map<std::string, uint32_t, KeyHash<std::string>, KeyEqual<std::string>> _clipNameIDs;
+	// indexed by ID - 1, points to the keys of the map above
+	std::vector<const std::string*> _clipNames;
+
+	StateDataContainer<uint32_t> _conditionStateData{ this };
 
 private:
 	OpenAnimationReplacer() = default;
@@ -11,8 +11,6 @@
 #include <REL/Relocation.h>
 #include <SKSE/SKSE.h>
 
-#include <effolkronium/random.hpp>
-
 #ifdef NDEBUG
 #	include <spdlog/sinks/basic_file_sink.h>
 #else
@@ -21,6 +19,7 @@
 #pragma warning(pop)
 
 #include <boost/container_hash/hash.hpp>
+#include <random>
 #include <ranges>
 #include <shared_mutex>
 
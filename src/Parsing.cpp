@@ -348,6 +348,11 @@ namespace Parsing
 						a_outParseResult.blendTimeOnInterrupt = it->value.GetFloat();
 					}
 				}
+
+				// read interrupt evaluation interval (optional)
+				if (auto it = doc.FindMember("interruptEvaluationInterval"); it != doc.MemberEnd() && it->value.IsNumber()) {
+					a_outParseResult.interruptEvaluationInterval = it->value.GetFloat();
+				}
 			}
 
 			// read replace on loop (optional)
@@ -110,6 +110,7 @@ namespace Parsing
 		bool bInterruptible = false;
 		bool bCustomBlendTimeOnInterrupt = false;
 		float blendTimeOnInterrupt = Settings::fDefaultBlendTimeOnInterrupt;
+		float interruptEvaluationInterval = 0.f;
 		bool bReplaceOnLoop = true;
 		bool bCustomBlendTimeOnLoop = false;
 		float blendTimeOnLoop = Settings::fDefaultBlendTimeOnLoop;
@@ -0,0 +1,155 @@
+#include "PoseBlending.h"
+
+#include <emmintrin.h>
+
+namespace PoseBlending
+{
+	namespace
+	{
+		struct TransformSSE
+		{
+			__m128 translation;
+			__m128 rotation;
+			__m128 scale;
+		};
+
+		TransformSSE Load(const float* a_transform)
+		{
+			return { _mm_load_ps(a_transform), _mm_load_ps(a_transform + 4), _mm_load_ps(a_transform + 8) };
+		}
+
+		void Store(const TransformSSE& a_transform, float* a_out)
+		{
+			_mm_store_ps(a_out, a_transform.translation);
+			_mm_store_ps(a_out + 4, a_transform.rotation);
+			_mm_store_ps(a_out + 8, a_transform.scale);
+		}
+
+		// summed in the same order as the scalar version, so the results match exactly
+		__m128 Dot4(__m128 a_lhs, __m128 a_rhs)
+		{
+			const __m128 product = _mm_mul_ps(a_lhs, a_rhs);
+			__m128 sum = _mm_add_ss(product, _mm_shuffle_ps(product, product, _MM_SHUFFLE(1, 1, 1, 1)));
+			sum = _mm_add_ss(sum, _mm_shuffle_ps(product, product, _MM_SHUFFLE(2, 2, 2, 2)));
+			sum = _mm_add_ss(sum, _mm_shuffle_ps(product, product, _MM_SHUFFLE(3, 3, 3, 3)));
+			return _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(0, 0, 0, 0));
+		}
+
+		__m128 Lerp(__m128 a_from, __m128 a_to, __m128 a_amount)
+		{
+			return _mm_add_ps(a_from, _mm_mul_ps(_mm_sub_ps(a_to, a_from), a_amount));
+		}
+
+		TransformSSE Blend(const TransformSSE& a_src, const TransformSSE& a_dst, __m128 a_amount)
+		{
+			TransformSSE result;
+			result.translation = Lerp(a_src.translation, a_dst.translation, a_amount);
+			result.scale = Lerp(a_src.scale, a_dst.scale, a_amount);
+
+			// flip the destination rotation into the same hemisphere by flipping its sign bits
+			const __m128 signMask = _mm_and_ps(_mm_cmplt_ps(Dot4(a_src.rotation, a_dst.rotation), _mm_setzero_ps()), _mm_set1_ps(-0.f));
+			const __m128 dstRotation = _mm_xor_ps(a_dst.rotation, signMask);
+
+			const __m128 rotation = Lerp(a_src.rotation, dstRotation, a_amount);
+			const __m128 invLength = _mm_div_ps(_mm_set1_ps(1.f), _mm_sqrt_ps(Dot4(rotation, rotation)));
+			result.rotation = _mm_mul_ps(rotation, invLength);
+
+			return result;
+		}
+
+		struct TransformScalar
+		{
+			float translation[4];
+			float rotation[4];
+			float scale[4];
+		};
+
+		TransformScalar LoadScalar(const float* a_transform)
+		{
+			TransformScalar result;
+			std::memcpy(&result, a_transform, sizeof(TransformScalar));
+			return result;
+		}
+
+		void StoreScalar(const TransformScalar& a_transform, float* a_out)
+		{
+			std::memcpy(a_out, &a_transform, sizeof(TransformScalar));
+		}
+
+		float Dot4Scalar(const float* a_lhs, const float* a_rhs)
+		{
+			float sum = a_lhs[0] * a_rhs[0];
+			sum += a_lhs[1] * a_rhs[1];
+			sum += a_lhs[2] * a_rhs[2];
+			sum += a_lhs[3] * a_rhs[3];
+			return sum;
+		}
+
+		TransformScalar BlendScalar(const TransformScalar& a_src, const TransformScalar& a_dst, float a_amount)
+		{
+			TransformScalar result;
+
+			const bool bFlip = Dot4Scalar(a_src.rotation, a_dst.rotation) < 0.f;
+
+			for (size_t i = 0; i < 4; ++i) {
+				result.translation[i] = a_src.translation[i] + (a_dst.translation[i] - a_src.translation[i]) * a_amount;
+				result.scale[i] = a_src.scale[i] + (a_dst.scale[i] - a_src.scale[i]) * a_amount;
+
+				const float dstRotation = bFlip ? -a_dst.rotation[i] : a_dst.rotation[i];
+				result.rotation[i] = a_src.rotation[i] + (dstRotation - a_src.rotation[i]) * a_amount;
+			}
+
+			const float invLength = 1.f / std::sqrt(Dot4Scalar(result.rotation, result.rotation));
+			for (float& component : result.rotation) {
+				component *= invLength;
+			}
+
+			return result;
+		}
+	}
+
+	void BlendPoseStack(const float* const* a_poses, const uint32_t* a_trackCounts, const float* a_amounts, size_t a_numPoses, uint32_t a_numTracks, float* a_inOutPose)
+	{
+		if (a_numPoses == 0) {
+			return;
+		}
+
+		const uint32_t numTracks = std::min(a_numTracks, a_trackCounts[0]);
+
+		for (uint32_t track = 0; track < numTracks; ++track) {
+			const size_t offset = static_cast<size_t>(track) * kFloatsPerTransform;
+
+			// keep the accumulated transform in registers while walking the stack, instead of a full pass over the skeleton per pose
+			TransformSSE accumulated = Load(a_poses[0] + offset);
+			for (size_t pose = 1; pose < a_numPoses; ++pose) {
+				if (track < a_trackCounts[pose]) {
+					accumulated = Blend(Load(a_poses[pose] + offset), accumulated, _mm_set1_ps(a_amounts[pose - 1]));
+				}
+			}
+
+			Store(Blend(Load(a_inOutPose + offset), accumulated, _mm_set1_ps(a_amounts[a_numPoses - 1])), a_inOutPose + offset);
+		}
+	}
+
+	void BlendPoseStackScalar(const float* const* a_poses, const uint32_t* a_trackCounts, const float* a_amounts, size_t a_numPoses, uint32_t a_numTracks, float* a_inOutPose)
+	{
+		if (a_numPoses == 0) {
+			return;
+		}
+
+		const uint32_t numTracks = std::min(a_numTracks, a_trackCounts[0]);
+
+		for (uint32_t track = 0; track < numTracks; ++track) {
+			const size_t offset = static_cast<size_t>(track) * kFloatsPerTransform;
+
+			TransformScalar accumulated = LoadScalar(a_poses[0] + offset);
+			for (size_t pose = 1; pose < a_numPoses; ++pose) {
+				if (track < a_trackCounts[pose]) {
+					accumulated = BlendScalar(LoadScalar(a_poses[pose] + offset), accumulated, a_amounts[pose - 1]);
+				}
+			}
+
+			StoreScalar(BlendScalar(LoadScalar(a_inOutPose + offset), accumulated, a_amounts[a_numPoses - 1]), a_inOutPose + offset);
+		}
+	}
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+// blends a stack of sampled poses into an output pose in a single pass over the tracks
+// poses are plain float arrays laid out like hkQsTransform - translation xyzw, rotation xyzw, scale xyzw per track, 16 byte aligned
+namespace PoseBlending
+{
+	constexpr size_t kFloatsPerTransform = 12;
+
+	// a_poses are ordered from the oldest to the newest, a_trackCounts holds the number of sampled tracks in each of them
+	// a_amounts[i] is the weight of the poses [0, i] blended together when blending them over the next pose, the last one is used to blend the result over a_inOutPose
+	// matches chaining hkbBlendPoses pairwise (translation and scale lerp, rotation nlerp with hemisphere correction), tracks the oldest pose doesn't have are left untouched
+	void BlendPoseStack(const float* const* a_poses, const uint32_t* a_trackCounts, const float* a_amounts, size_t a_numPoses, uint32_t a_numTracks, float* a_inOutPose);
+
+	// same as above without SSE, the results are bitwise identical
+	void BlendPoseStackScalar(const float* const* a_poses, const uint32_t* a_trackCounts, const float* a_amounts, size_t a_numPoses, uint32_t a_numTracks, float* a_inOutPose);
+}
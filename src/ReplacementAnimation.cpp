@@ -100,10 +100,10 @@ bool ReplacementAnimation::IsDisabled() const
 	return _bDisabled || _parentSubMod->IsDisabled();
 }
 
-uint16_t ReplacementAnimation::GetIndex(Variant*& a_outVariant) const
+uint16_t ReplacementAnimation::GetIndex(const RE::TESObjectREFR* a_refr, Variant*& a_outVariant) const
 {
 	if (HasVariants()) {
-		return std::get<Variants>(_index).GetVariantIndex(a_outVariant);
+		return std::get<Variants>(_index).GetVariantIndex(a_refr, a_outVariant);
 	}
 
 	return std::get<uint16_t>(_index);
@@ -169,7 +169,7 @@ float ReplacementAnimation::GetCustomBlendTime(ActiveClip* a_activeClip, CustomB
 						return 0.f;
 					}
 					if (const auto stateData = variants.GetVariantStateData(a_activeClip)) {
-						if (!stateData->IsAtBeginningOfSequence(a_activeClip->GetClipGenerator(), &variants)) {
+						if (!stateData->IsAtBeginningOfSequence(a_activeClip, &variants)) {
 							return 0.f;
 						}
 					}
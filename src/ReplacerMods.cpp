@@ -114,6 +114,7 @@ void SubMod::LoadParseResult(const Parsing::SubModParseResult& a_parseResult)
 	_bInterruptible = a_parseResult.bInterruptible;
 	_bCustomBlendTimeOnInterrupt = a_parseResult.bCustomBlendTimeOnInterrupt;
 	_blendTimeOnInterrupt = a_parseResult.blendTimeOnInterrupt;
+	_interruptEvaluationInterval = a_parseResult.interruptEvaluationInterval;
 	_bReplaceOnLoop = a_parseResult.bReplaceOnLoop;
 	_bCustomBlendTimeOnLoop = a_parseResult.bCustomBlendTimeOnLoop;
 	_blendTimeOnLoop = a_parseResult.blendTimeOnLoop;
@@ -559,6 +560,12 @@ void SubMod::Serialize(rapidjson::Document& a_doc, ConditionEditMode a_editMode)
 		a_doc.AddMember("blendTimeOnInterrupt", blendValue, allocator);
 	}
 
+	// write interrupt evaluation interval (0 is default so skip)
+	if (_bInterruptible && _interruptEvaluationInterval > 0.f) {
+		rapidjson::Value value(_interruptEvaluationInterval);
+		a_doc.AddMember("interruptEvaluationInterval", value, allocator);
+	}
+
 	// write replace on loop (true is default so skip)
 	if (!_bReplaceOnLoop) {
 		rapidjson::Value value(_bReplaceOnLoop);
@@ -646,6 +653,7 @@ void SubMod::ResetToLegacy()
 	_bInterruptible = false;
 	_bCustomBlendTimeOnInterrupt = false;
 	_blendTimeOnInterrupt = Settings::fDefaultBlendTimeOnInterrupt;
+	_interruptEvaluationInterval = 0.f;
 	_bReplaceOnLoop = true;
 	_bCustomBlendTimeOnLoop = false;
 	_blendTimeOnLoop = Settings::fDefaultBlendTimeOnLoop;
@@ -1254,6 +1262,30 @@ uint16_t ReplacerProjectData::TryAddAnimationToAnimationBundleNames(std::string_
 	return newIndex;
 }
 
+uint32_t ReplacerProjectData::GetAnimationFileSize(uint16_t a_index) const
+{
+	// the file size is a close enough estimate of the memory the animation takes once loaded
+	// not read at parse time so loading the mods doesn't stat every animation file, only the ones that actually get loaded
+	if (a_index >= stringData->animationNames.size()) {
+		return 0;
+	}
+
+	std::error_code errorCode;
+	const auto fileSize = std::filesystem::file_size(stringData->animationNames[a_index].data(), errorCode);
+	return errorCode ? 0 : static_cast<uint32_t>(fileSize);
+}
+
+bool ReplacerProjectData::IsSynchronizedReplacementIndex(uint16_t a_index) const
+{
+	if (const auto it = replacementIndexToOriginalIndexMap.find(a_index); it != replacementIndexToOriginalIndexMap.end()) {
+		if (const auto replacements = GetAnimationReplacements(it->second)) {
+			return replacements->IsSynchronizedAnimation();
+		}
+	}
+
+	return false;
+}
+
 void ReplacerProjectData::AddReplacementAnimation(RE::hkbCharacterStringData* a_stringData, uint16_t a_originalIndex, std::unique_ptr<ReplacementAnimation>& a_replacementAnimation)
 {
 	auto addReplacementIndex = [&](uint16_t a_index) {
@@ -1268,7 +1300,7 @@ void ReplacerProjectData::AddReplacementAnimation(RE::hkbCharacterStringData* a_
 		});
 	} else {
 		Variant* dummy = nullptr;
-		const uint16_t replacementIndex = a_replacementAnimation->GetIndex(dummy);
+		const uint16_t replacementIndex = a_replacementAnimation->GetIndex(nullptr, dummy);
 		if (replacementIndex != static_cast<uint16_t>(-1)) {
 			addReplacementIndex(replacementIndex);
 		}
@@ -1291,17 +1323,6 @@ void ReplacerProjectData::SortReplacementAnimationsByPriority(uint16_t a_origina
 	}
 }
 
-void ReplacerProjectData::QueueReplacementAnimations(RE::hkbCharacter* a_character)
-{
-	OpenAnimationReplacer::bIsPreLoading = true;
-	for (const auto& animIndex : animationsToQueue) {
-		OpenAnimationReplacer::LoadAnimation(a_character, animIndex);
-	}
-	OpenAnimationReplacer::bIsPreLoading = false;
-
-	animationsToQueue.clear();
-}
-
 void ReplacerProjectData::MarkSynchronizedReplacementAnimations(RE::hkbGenerator* a_rootGenerator)
 {
 	if (!a_rootGenerator) {
@@ -76,6 +76,10 @@ public:
 	bool IsInterruptible() const { return _bInterruptible; }
 	void SetInterruptible(bool a_bInterruptible) { _bInterruptible = a_bInterruptible; }
 
+	// minimum time between interrupt checks of a clip from this submod, 0 means every update
+	float GetInterruptEvaluationInterval() const { return _interruptEvaluationInterval; }
+	void SetInterruptEvaluationInterval(float a_interval) { _interruptEvaluationInterval = a_interval; }
+
 	bool HasCustomBlendTime(CustomBlendType a_type) const;
 	float GetCustomBlendTime(CustomBlendType a_type) const;
 	void ToggleCustomBlendTime(CustomBlendType a_type, bool a_bEnable);
@@ -122,7 +126,7 @@ public:
 	void ForEachReplacementAnimation(const std::function<void(ReplacementAnimation*)>& a_func) const;
 	void ForEachReplacementAnimationFile(const std::function<void(const ReplacementAnimationFile&)>& a_func) const;
 
-	StateDataContainer<const Conditions::ICondition*> conditionStateData;
+	StateDataContainer<const Conditions::ICondition*> conditionStateData{ this };
 
 private:
 	friend class ReplacerMod;
@@ -142,6 +146,7 @@ private:
 	bool _bInterruptible = false;
 	bool _bCustomBlendTimeOnInterrupt = false;
 	float _blendTimeOnInterrupt = Settings::fDefaultBlendTimeOnInterrupt;
+	float _interruptEvaluationInterval = 0.f;
 	bool _bReplaceOnLoop = true;
 	bool _bCustomBlendTimeOnLoop = false;
 	float _blendTimeOnLoop = Settings::fDefaultBlendTimeOnLoop;
@@ -222,8 +227,8 @@ public:
 
 	bool HasInvalidConditions() const;
 
-	StateDataContainer<std::string> conditionStateData;
-	VariantStateDataContainer variantStateData;
+	StateDataContainer<uint32_t> conditionStateData{ this };
+	VariantStateDataContainer variantStateData{ this };
 
 private:
 	std::string _name;
@@ -266,6 +271,7 @@ public:
 	void TestReplaceOnEcho();
 
 	void MarkAsSynchronizedAnimation(bool a_bSynchronized);
+	[[nodiscard]] bool IsSynchronizedAnimation() const { return _bSynchronized; }
 
 protected:
 	mutable SharedLock _lock;
@@ -293,10 +299,12 @@ public:
 	uint16_t TryAddAnimationToAnimationBundleNames(std::string_view a_path, const std::optional<std::string>& a_hash);
 	void AddReplacementAnimation(RE::hkbCharacterStringData* a_stringData, uint16_t a_originalIndex, std::unique_ptr<ReplacementAnimation>& a_replacementAnimation);
 	void SortReplacementAnimationsByPriority(uint16_t a_originalIndex);
-	void QueueReplacementAnimations(RE::hkbCharacter* a_character);
 	void MarkSynchronizedReplacementAnimations(RE::hkbGenerator* a_rootGenerator);
 
 	[[nodiscard]] uint32_t GetFilteredDuplicateCount() const { return _filteredDuplicates; }
+	[[nodiscard]] uint32_t GetAnimationFileSize(uint16_t a_index) const;
+	// whether the animation at the index replaces an animation played by synchronized clips
+	[[nodiscard]] bool IsSynchronizedReplacementIndex(uint16_t a_index) const;
 
 	[[nodiscard]] AnimationReplacements* GetAnimationReplacements(uint16_t a_originalIndex) const;
 
@@ -103,8 +103,21 @@ void Settings::ReadSettings()
 			// General
 			ReadUInt16Setting(ini, "General", "uAnimationLimit", uAnimationLimit);
 			ReadUInt32Setting(ini, "General", "uHavokHeapSize", uHavokHeapSize);
+			ReadBoolSetting(ini, "General", "bEnableHavokHeapTelemetry", bEnableHavokHeapTelemetry);
+			ReadBoolSetting(ini, "General", "bAutoHavokHeapSize", bAutoHavokHeapSize);
 			ReadBoolSetting(ini, "General", "bAsyncParsing", bAsyncParsing);
 			ReadBoolSetting(ini, "General", "bLoadDefaultBehaviorsInMainMenu", bLoadDefaultBehaviorsInMainMenu);
+			ReadUInt32Setting(ini, "General", "uPreloadBudgetPerFrame", uPreloadBudgetPerFrame);
+			ReadBoolSetting(ini, "General", "bEnableAnimationEviction", bEnableAnimationEviction);
+			ReadUInt32Setting(ini, "General", "uAnimationEvictionBudget", uAnimationEvictionBudget);
+			ReadFloatSetting(ini, "General", "fAnimationEvictionIdleTime", fAnimationEvictionIdleTime);
+			ReadBoolSetting(ini, "General", "bEnableConditionFactCache", bEnableConditionFactCache);
+
+			// Blending
+			ReadBoolSetting(ini, "Blending", "bEnableBlendLOD", bEnableBlendLOD);
+			ReadFloatSetting(ini, "Blending", "fBlendLODReducedDistance", fBlendLODReducedDistance);
+			ReadFloatSetting(ini, "Blending", "fBlendLODHardCutDistance", fBlendLODHardCutDistance);
+			ReadUInt32Setting(ini, "Blending", "uBlendLODReducedTrackCount", uBlendLODReducedTrackCount);
 
 			// Duplicate filtering
 			ReadBoolSetting(ini, "Filtering", "bFilterOutDuplicateAnimations", bFilterOutDuplicateAnimations);
@@ -149,6 +162,8 @@ void Settings::ReadSettings()
 
 			// Debug
 			ReadBoolSetting(ini, "Debug", "bEnableDebugDraws", bEnableDebugDraws);
+			ReadBoolSetting(ini, "Debug", "bDeterministicRandom", bDeterministicRandom);
+			ReadUInt32Setting(ini, "Debug", "uDeterministicRandomSeed", uDeterministicRandomSeed);
 
 			return true;
 		}
@@ -178,8 +193,21 @@ void Settings::WriteSettings()
 	// General
 	ini.SetLongValue("General", "uAnimationLimit", uAnimationLimit);
 	ini.SetLongValue("General", "uHavokHeapSize", uHavokHeapSize);
+	ini.SetBoolValue("General", "bEnableHavokHeapTelemetry", bEnableHavokHeapTelemetry);
+	ini.SetBoolValue("General", "bAutoHavokHeapSize", bAutoHavokHeapSize);
 	ini.SetBoolValue("General", "bAsyncParsing", bAsyncParsing);
 	ini.SetBoolValue("General", "bLoadDefaultBehaviorsInMainMenu", bLoadDefaultBehaviorsInMainMenu);
+	ini.SetLongValue("General", "uPreloadBudgetPerFrame", uPreloadBudgetPerFrame);
+	ini.SetBoolValue("General", "bEnableAnimationEviction", bEnableAnimationEviction);
+	ini.SetLongValue("General", "uAnimationEvictionBudget", uAnimationEvictionBudget);
+	ini.SetDoubleValue("General", "fAnimationEvictionIdleTime", fAnimationEvictionIdleTime);
+	ini.SetBoolValue("General", "bEnableConditionFactCache", bEnableConditionFactCache);
+
+	// Blending
+	ini.SetBoolValue("Blending", "bEnableBlendLOD", bEnableBlendLOD);
+	ini.SetDoubleValue("Blending", "fBlendLODReducedDistance", fBlendLODReducedDistance);
+	ini.SetDoubleValue("Blending", "fBlendLODHardCutDistance", fBlendLODHardCutDistance);
+	ini.SetLongValue("Blending", "uBlendLODReducedTrackCount", uBlendLODReducedTrackCount);
 
 	// Duplicate filtering
 	ini.SetBoolValue("Filtering", "bFilterOutDuplicateAnimations", bFilterOutDuplicateAnimations);
@@ -224,6 +252,8 @@ void Settings::WriteSettings()
 
 	// Debug
 	ini.SetBoolValue("Debug", "bEnableDebugDraws", bEnableDebugDraws);
+	ini.SetBoolValue("Debug", "bDeterministicRandom", bDeterministicRandom);
+	ini.SetLongValue("Debug", "uDeterministicRandomSeed", uDeterministicRandomSeed);
 
 	ini.SaveFile(iniPath.data());
 
@@ -18,8 +18,21 @@ struct Settings
 	// General
 	static inline uint16_t uAnimationLimit = 0x7FFF;
 	static inline uint32_t uHavokHeapSize = 0x40000000;
+	static inline bool bEnableHavokHeapTelemetry = false;
+	static inline bool bAutoHavokHeapSize = false;
 	static inline bool bAsyncParsing = true;
 	static inline bool bLoadDefaultBehaviorsInMainMenu = true;
+	static inline uint32_t uPreloadBudgetPerFrame = 256;
+	static inline bool bEnableAnimationEviction = false;
+	static inline uint32_t uAnimationEvictionBudget = 1024;
+	static inline float fAnimationEvictionIdleTime = 300.f;
+	static inline bool bEnableConditionFactCache = true;
+
+	// Blending
+	static inline bool bEnableBlendLOD = false;
+	static inline float fBlendLODReducedDistance = 2048.f;
+	static inline float fBlendLODHardCutDistance = 6144.f;
+	static inline uint32_t uBlendLODReducedTrackCount = 32;
 
 	// Duplicate filtering
 	static inline bool bFilterOutDuplicateAnimations = true;
@@ -61,17 +74,30 @@ struct Settings
 
 	// Debug
 	static inline bool bEnableDebugDraws = false;
+	static inline bool bDeterministicRandom = false;
+	static inline uint32_t uDeterministicRandomSeed = 0;
 
 	// Internal
 	constexpr static inline float fDefaultBlendTimeOnInterrupt = 0.3f;
 	constexpr static inline float fDefaultBlendTimeOnLoop = 0.3f;
 	constexpr static inline float fDefaultBlendTimeOnEcho = 0.1f;
+	constexpr static inline float fDefaultBlendTimeOnLazyLoad = 0.2f;
+	constexpr static inline float fLazyLoadMaxWaitTime = 2.f;
+	constexpr static inline uint32_t uLazyLoadPrefetchCount = 2;
+	constexpr static inline float fAnimationEvictionCheckInterval = 1.f;
+	constexpr static inline uint32_t uHavokHeapSizeMin = 0x20000000;
+	constexpr static inline uint32_t uHavokHeapSizeMax = 0x7FC00000;
+	constexpr static inline float fHavokHeapAutoHeadroom = 0.25f;
+	constexpr static inline float fHavokHeapFullThreshold = 0.95f;
+	constexpr static inline uint32_t uHavokHeapSessionHistory = 5;
 	constexpr static inline float fStateDataLifetime = 0.5f;
 	constexpr static inline float fSequentialVariantLifetime = 0.5f;
 	constexpr static inline float fQueueFadeTime = 1.f;
 	constexpr static inline uint32_t uQueueMinSize = 10;
 	constexpr static inline float fAnimationLogEntryFadeTime = 0.5f;
+	constexpr static inline size_t uAnimationLogQueueCapacity = 256;
 	constexpr static inline float fAnimationEventLogEntryColorTimeLong = 1.f;
+	constexpr static inline uint32_t uAnimationEventLogCapacity = 2000;
 	constexpr static inline float fWelcomeBannerFadeTime = 1.f;
 
 	static inline uint16_t maxAnimLimitDefault = 0x7FFF;
@@ -82,6 +108,7 @@ struct Settings
 	constexpr static inline std::string_view iniPath = "Data/SKSE/Plugins/OpenAnimationReplacer.ini";
 	constexpr static inline std::string_view imguiIni = "Data/SKSE/Plugins/OpenAnimationReplacer_ImGui.ini";
 	constexpr static inline std::string_view animationFileHashCachePath = "Data/SKSE/Plugins/OpenAnimationReplacer_animFileHashCache.bin";
+	constexpr static inline std::string_view havokHeapStatsPath = "Data/SKSE/Plugins/OpenAnimationReplacer_havokHeapStats.bin";
 
 	constexpr static inline std::string_view synchronizedClipSourcePrefix = "NPC";
 	constexpr static inline std::string_view synchronizedClipTargetPrefix = "2_";
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <array>
+
+// mixes the hash again so the shard index doesn't correlate with the bucket index inside the shard
+inline size_t GetShardIndex(uint64_t a_hash, size_t a_shardCount)
+{
+	a_hash ^= a_hash >> 33;
+	a_hash *= 0xFF51AFD7ED558CCDull;
+	a_hash ^= a_hash >> 33;
+	return static_cast<size_t>(a_hash % a_shardCount);
+}
+
+// hash map split into independently locked shards, so threads working on different keys (e.g. different characters' behavior graphs) rarely block each other
+// the values are only accessed inside the callbacks, while the shard lock is held
+template <typename Key, typename Value, size_t ShardCount = 16>
+class ShardedMap
+{
+public:
+	template <typename Func>
+	bool Visit(const Key& a_key, Func&& a_func) const
+	{
+		const auto& shard = GetShard(a_key);
+		ReadLocker locker(shard.lock);
+
+		if (const auto search = shard.map.find(a_key); search != shard.map.end()) {
+			a_func(search->second);
+			return true;
+		}
+
+		return false;
+	}
+
+	// calls the function with the existing value, or with a new one created by the factory. Returns true if the value was created
+	template <typename Factory, typename Func>
+	bool VisitOrEmplace(const Key& a_key, Factory&& a_factory, Func&& a_func)
+	{
+		auto& shard = GetShard(a_key);
+		WriteLocker locker(shard.lock);
+
+		auto [it, bInserted] = shard.map.try_emplace(a_key);
+		if (bInserted) {
+			it->second = a_factory();
+			++_size;
+		}
+
+		a_func(it->second);
+		return bInserted;
+	}
+
+	void InsertOrAssign(const Key& a_key, Value a_value)
+	{
+		auto& shard = GetShard(a_key);
+		WriteLocker locker(shard.lock);
+
+		if (shard.map.insert_or_assign(a_key, std::move(a_value)).second) {
+			++_size;
+		}
+	}
+
+	// the value is destroyed after the shard lock is released
+	bool Erase(const Key& a_key)
+	{
+		typename Map::node_type node;
+
+		{
+			auto& shard = GetShard(a_key);
+			WriteLocker locker(shard.lock);
+
+			node = shard.map.extract(a_key);
+			if (node) {
+				--_size;
+			}
+		}
+
+		return static_cast<bool>(node);
+	}
+
+	// removes the value if the predicate accepts it and hands it to the caller, so it can be used and destroyed after the shard lock is released
+	template <typename Pred>
+	Value ExtractIf(const Key& a_key, Pred&& a_pred)
+	{
+		auto& shard = GetShard(a_key);
+		WriteLocker locker(shard.lock);
+
+		if (const auto search = shard.map.find(a_key); search != shard.map.end() && a_pred(search->second)) {
+			Value value = std::move(search->second);
+			shard.map.erase(search);
+			--_size;
+			return value;
+		}
+
+		return Value{};
+	}
+
+	// locks one shard at a time, so it's not a consistent snapshot of the whole map
+	template <typename Func>
+	RE::BSVisit::BSVisitControl ForEach(Func&& a_func) const
+	{
+		for (const auto& shard : _shards) {
+			ReadLocker locker(shard.lock);
+
+			for (const auto& [key, value] : shard.map) {
+				if (a_func(key, value) == RE::BSVisit::BSVisitControl::kStop) {
+					return RE::BSVisit::BSVisitControl::kStop;
+				}
+			}
+		}
+
+		return RE::BSVisit::BSVisitControl::kContinue;
+	}
+
+	[[nodiscard]] bool Empty() const { return _size == 0; }
+	[[nodiscard]] size_t Size() const { return _size; }
+
+private:
+	using Map = std::unordered_map<Key, Value>;
+
+	struct Shard
+	{
+		mutable SharedLock lock;
+		Map map;
+	};
+
+	Shard& GetShard(const Key& a_key) { return _shards[GetShardIndex(std::hash<Key>{}(a_key), ShardCount)]; }
+	const Shard& GetShard(const Key& a_key) const { return _shards[GetShardIndex(std::hash<Key>{}(a_key), ShardCount)]; }
+
+	std::array<Shard, ShardCount> _shards;
+	std::atomic<size_t> _size = 0;
+};
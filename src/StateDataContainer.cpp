@@ -8,7 +8,7 @@ Conditions::IStateData* StateDataContainerEntry::AccessData(RE::hkbClipGenerator
 		AddActiveClip(activeClip);
 	}
 
-	_timeSinceLastAccess = 0.f;
+	_lastAccessTime = GetStateDataTime();
 	return _data.get();
 }
 
@@ -38,8 +38,6 @@ bool StateDataContainerEntry::CheckRelevantClips(ActiveClip* a_activeClip) const
 		}
 	}
 
-	return _activeClips.contains(a_activeClip->shared_from_this());
-
 	return false;
 }
 
@@ -58,20 +56,73 @@ bool StateDataContainerEntry::HasAnyActiveClips() const
 
 void StateDataContainerEntry::AddActiveClip(std::shared_ptr<ActiveClip>& a_activeClip)
 {
+	// this runs on every access, so avoid the write lock if the clip is already known
+	if (ContainsActiveClip(a_activeClip)) {
+		return;
+	}
+
 	WriteLocker locker(_clipsLock);
 
-	_activeClips.emplace(a_activeClip);
+	AddClip(_activeClips, a_activeClip);
 	if (_data->ShouldResetOnLoopOrEcho(a_activeClip->GetClipGenerator(), false) || _data->ShouldResetOnLoopOrEcho(a_activeClip->GetClipGenerator(), true)) {
-		_relevantClips.emplace(a_activeClip);
+		AddClip(_relevantClips, a_activeClip);
+	}
+}
+
+bool StateDataContainerEntry::ContainsActiveClip(const std::shared_ptr<ActiveClip>& a_activeClip) const
+{
+	ReadLocker locker(_clipsLock);
+
+	return std::ranges::any_of(_activeClips, [&](const auto& a_clip) {
+		return !a_clip.owner_before(a_activeClip) && !a_activeClip.owner_before(a_clip);
+	});
+}
+
+void StateDataContainerEntry::AddClip(std::vector<std::weak_ptr<ActiveClip>>& a_clips, const std::shared_ptr<ActiveClip>& a_activeClip)
+{
+	// drop the clips that have ended while we're at it
+	std::erase_if(a_clips, [](const auto& a_clip) { return a_clip.expired(); });
+
+	if (std::ranges::none_of(a_clips, [&](const auto& a_clip) { return !a_clip.owner_before(a_activeClip) && !a_activeClip.owner_before(a_clip); })) {
+		a_clips.emplace_back(a_activeClip);
 	}
 }
 
-void IStateDataContainerHolder::RegisterStateDataContainer()
+void IStateDataContainerHolder::RegisterStateDataContainer(RE::ObjectRefHandle a_refHandle)
 {
-	OpenAnimationReplacer::GetSingleton().RegisterStateData(this);
+	OpenAnimationReplacer::GetSingleton().RegisterStateData(this, a_refHandle);
 }
 
 void IStateDataContainerHolder::UnregisterStateDataContainer()
 {
 	OpenAnimationReplacer::GetSingleton().UnregisterStateData(this);
 }
+
+void IStateDataContainerHolder::OnStateDataRefrAdded(RE::ObjectRefHandle a_refHandle)
+{
+	Locker locker(_stateDataRefrsLock);
+
+	++_stateDataRefrContainerCounts[a_refHandle];
+}
+
+void IStateDataContainerHolder::OnStateDataRefrRemoved(RE::ObjectRefHandle a_refHandle)
+{
+	Locker locker(_stateDataRefrsLock);
+
+	if (const auto search = _stateDataRefrContainerCounts.find(a_refHandle); search != _stateDataRefrContainerCounts.end()) {
+		if (--search->second == 0) {
+			_stateDataRefrContainerCounts.erase(search);
+			_expiredStateDataRefrs.emplace_back(a_refHandle);
+		}
+	}
+}
+
+std::vector<RE::ObjectRefHandle> IStateDataContainerHolder::TakeExpiredStateDataRefrs()
+{
+	Locker locker(_stateDataRefrsLock);
+
+	// the ref might have gotten new data since it expired
+	std::erase_if(_expiredStateDataRefrs, [&](const auto& a_refHandle) { return _stateDataRefrContainerCounts.contains(a_refHandle); });
+
+	return std::exchange(_expiredStateDataRefrs, {});
+}
@@ -4,6 +4,7 @@
 
 #include <API/OpenAnimationReplacer-ConditionTypes.h>
 
+#include <queue>
 #include <unordered_set>
 
 class ActiveClip;
@@ -11,8 +12,8 @@ class ActiveClip;
 class StateDataContainerEntry
 {
 public:
-	StateDataContainerEntry(const RE::ObjectRefHandle& a_refHandle, Conditions::IStateData* a_data) :
-		_refHandle(a_refHandle), _data(a_data)
+	StateDataContainerEntry(const RE::ObjectRefHandle& a_refHandle, Conditions::IStateData* a_data, bool a_bTicking) :
+		_refHandle(a_refHandle), _data(a_data), _bTicking(a_bTicking), _lastAccessTime(GetStateDataTime())
 	{}
 
 	[[nodiscard]] RE::ObjectRefHandle GetRefHandle() const { return _refHandle; }
@@ -21,7 +22,7 @@ public:
 
 	void KeepAlive() const
 	{
-		_timeSinceLastAccess = 0.f;
+		_lastAccessTime = GetStateDataTime();
 	}
 
 	void OnLoopOrEcho(ActiveClip* a_clipGenerator, bool a_bIsEcho);
@@ -32,31 +33,48 @@ public:
 	{
 		if (_lastUpdateTimestamp != g_durationOfApplicationRunTimeMS) {  // only run if last update was not this frame
 			_lastUpdateTimestamp = g_durationOfApplicationRunTimeMS;
-			if (!_data->Update(a_deltaTime) && !HasAnyActiveClips() && _timeSinceLastAccess > Settings::fStateDataLifetime) {  // expired
+			if (!_data->Update(a_deltaTime) && !HasAnyActiveClips() && IsPastLifetime()) {  // expired
 				return false;
 			}
-
-			_timeSinceLastAccess += a_deltaTime;
 		}
 
 		return true;
 	}
 
+	// entries whose state data doesn't need Update don't have to be updated every frame, only checked once they're due to expire. Set by whoever adds the data
+	[[nodiscard]] bool IsTicking() const { return _bTicking; }
+	[[nodiscard]] bool IsPastLifetime() const { return GetStateDataTime() - _lastAccessTime > Settings::fStateDataLifetime; }
+	[[nodiscard]] bool HasAnyActiveClips() const;
+
+	[[nodiscard]] float GetDeadline() const { return _lastAccessTime + Settings::fStateDataLifetime; }
+	[[nodiscard]] float GetScheduledDeadline() const { return _scheduledDeadline; }
+	void SetScheduledDeadline(float a_deadline) { _scheduledDeadline = a_deadline; }
+
+	// state data time only advances while state data updates run, so nothing ages while the game is paused
+	static float GetStateDataTime() { return _stateDataTime; }
+	static void AdvanceStateDataTime(float a_deltaTime) { _stateDataTime += a_deltaTime; }
+
 private:
 	bool CheckRelevantClips(ActiveClip* a_activeClip) const;
-	bool HasAnyActiveClips() const;
 
 	void AddActiveClip(std::shared_ptr<ActiveClip>& a_activeClip);
+	bool ContainsActiveClip(const std::shared_ptr<ActiveClip>& a_activeClip) const;
+	static void AddClip(std::vector<std::weak_ptr<ActiveClip>>& a_clips, const std::shared_ptr<ActiveClip>& a_activeClip);
 
 	RE::ObjectRefHandle _refHandle;
 	std::unique_ptr<Conditions::IStateData> _data;
 
 	mutable SharedLock _clipsLock;
-	std::set<std::weak_ptr<ActiveClip>, std::owner_less<std::weak_ptr<ActiveClip>>> _activeClips{};
-	std::set<std::weak_ptr<ActiveClip>, std::owner_less<std::weak_ptr<ActiveClip>>> _relevantClips{};
+	// usually only one or two clips, so plain vectors are cheaper than node based sets here
+	std::vector<std::weak_ptr<ActiveClip>> _activeClips{};
+	std::vector<std::weak_ptr<ActiveClip>> _relevantClips{};
 
+	bool _bTicking;
 	uint32_t _lastUpdateTimestamp = 0;
-	mutable float _timeSinceLastAccess = 0.f;
+	mutable float _lastAccessTime;
+	float _scheduledDeadline = 0.f;
+
+	static inline float _stateDataTime = 0.f;
 };
 
 // Equality functor template
@@ -130,8 +148,20 @@ public:
 	virtual bool StateDataClearRefrData(RE::ObjectRefHandle a_refHandle) = 0;
 	virtual void StateDataClearData() = 0;
 
-	void RegisterStateDataContainer();
+	void RegisterStateDataContainer(RE::ObjectRefHandle a_refHandle);
 	void UnregisterStateDataContainer();
+
+	// called by the holder's containers when a ref gets its first entry or loses its last one
+	void OnStateDataRefrAdded(RE::ObjectRefHandle a_refHandle);
+	void OnStateDataRefrRemoved(RE::ObjectRefHandle a_refHandle);
+
+	// refs that none of the holder's containers have entries for anymore, so they can be dropped from the registered state data index
+	std::vector<RE::ObjectRefHandle> TakeExpiredStateDataRefrs();
+
+private:
+	ExclusiveLock _stateDataRefrsLock;
+	std::unordered_map<RE::ObjectRefHandle, uint32_t> _stateDataRefrContainerCounts;
+	std::vector<RE::ObjectRefHandle> _expiredStateDataRefrs;
 };
 
 template <typename T = void>
@@ -140,6 +170,10 @@ class StateDataContainer
 public:
 	using Key = std::conditional_t<std::is_same_v<T, void>, RE::ObjectRefHandle, std::pair<RE::ObjectRefHandle, T>>;
 
+	explicit StateDataContainer(IStateDataContainerHolder* a_holder) :
+		_holder(a_holder)
+	{}
+
 	size_t GetDataCount() const
 	{
 		ReadLocker locker(_stateDataLock);
@@ -151,16 +185,40 @@ public:
 	{
 		WriteLocker locker(_stateDataLock);
 
-		for (auto it = _stateData.begin(); it != _stateData.end();) {
-			auto& entry = it->second;
-			if (entry.Update(a_deltaTime)) {
-				++it;
+		std::vector<Key> expiredKeys;
+
+		for (const auto& key : _tickingKeys) {
+			if (const auto search = _stateData.find(key); search != _stateData.end() && !search->second.Update(a_deltaTime)) {
+				expiredKeys.emplace_back(key);
+			}
+		}
+
+		// only pop the entries that are due. Accessing an entry just moves its deadline, so its heap record is rescheduled lazily when popped
+		const float currentTime = StateDataContainerEntry::GetStateDataTime();
+		while (!_deadlines.empty() && _deadlines.top().first <= currentTime) {
+			const auto [deadline, key] = _deadlines.top();
+			_deadlines.pop();
+
+			const auto search = _stateData.find(key);
+			if (search == _stateData.end() || search->second.GetScheduledDeadline() != deadline) {
+				continue;  // stale record, the entry has been removed or rescheduled since
+			}
+
+			auto& entry = search->second;
+			if (!entry.IsPastLifetime()) {
+				Schedule(key, entry, entry.GetDeadline());
+			} else if (entry.HasAnyActiveClips()) {
+				// active clips don't notify when they end, so check again on the next update
+				Schedule(key, entry, currentTime);
 			} else {
-				_keyMap.erase(entry.GetRefHandle());
-				it = _stateData.erase(it);
+				expiredKeys.emplace_back(key);
 			}
 		}
 
+		for (const auto& key : expiredKeys) {
+			EraseEntry(key);
+		}
+
 		return !_stateData.empty();
 	}
 
@@ -169,19 +227,23 @@ public:
 	{
 		WriteLocker locker(_stateDataLock);
 
-		for (auto it = _stateData.begin(); it != _stateData.end();) {
-			auto& entry = it->second;
+		std::vector<Key> expiredKeys;
+
+		for (auto& [key, entry] : _stateData) {
 			if (entry.Update(a_deltaTime)) {
-				a_outActiveKeys.emplace(it->first);
-				++it;
-			} else if (a_outActiveKeys.contains(it->first)) {
-				++it;
-			} else {
-				_keyMap.erase(entry.GetRefHandle());
-				it = _stateData.erase(it);
+				a_outActiveKeys.emplace(key);
+			} else if (!a_outActiveKeys.contains(key)) {
+				expiredKeys.emplace_back(key);
 			}
 		}
 
+		for (const auto& key : expiredKeys) {
+			EraseEntry(key);
+		}
+
+		// every entry is visited above, so the deadlines are not needed here
+		_deadlines = {};
+
 		return !_stateData.empty();
 	}
 
@@ -190,14 +252,20 @@ public:
 		WriteLocker locker(_stateDataLock);
 
 		if (const auto keySearch = _keyMap.find(a_refHandle); keySearch != _keyMap.end()) {
+			std::vector<Key> resetKeys;
+
 			for (auto& key : keySearch->second) {
 				if (const auto search = _stateData.find(key); search != _stateData.end()) {
 					search->second.OnLoopOrEcho(a_activeClip, a_bIsEcho);
 					if (search->second.ShouldResetOnLoopOrEcho(a_activeClip, a_bIsEcho)) {
-						_stateData.erase(search);
+						resetKeys.emplace_back(key);
 					}
 				}
 			}
+
+			for (const auto& key : resetKeys) {
+				EraseEntry(key);
+			}
 		}
 
 		return !_stateData.empty();
@@ -207,12 +275,12 @@ public:
 	{
 		WriteLocker locker(_stateDataLock);
 
-		if (const auto keySearch = _keyMap.find(a_refHandle); keySearch != _keyMap.end()) {
-			for (auto& key : keySearch->second) {
-				if (const auto search = _stateData.find(key); search != _stateData.end()) {
-					_stateData.erase(search);
-				}
+		if (auto keyNode = _keyMap.extract(a_refHandle)) {
+			for (auto& key : keyNode.mapped()) {
+				_stateData.erase(key);
+				_tickingKeys.erase(key);
 			}
+			_holder->OnStateDataRefrRemoved(a_refHandle);
 		}
 
 		return !_stateData.empty();
@@ -222,7 +290,14 @@ public:
 	{
 		WriteLocker locker(_stateDataLock);
 
+		for (const auto& refHandle : _keyMap | std::views::keys) {
+			_holder->OnStateDataRefrRemoved(refHandle);
+		}
+
 		_stateData.clear();
+		_keyMap.clear();
+		_tickingKeys.clear();
+		_deadlines = {};
 	}
 
 	Conditions::IStateData* AccessStateData(Key a_key, RE::hkbClipGenerator* a_clipGenerator)
@@ -248,13 +323,14 @@ public:
 	}
 
 	template <typename KeyType = Key>
-	std::enable_if_t<std::is_same_v<KeyType, std::pair<RE::ObjectRefHandle, T>>, Conditions::IStateData*> AddStateData(Key a_key, Conditions::IStateData* a_stateData, RE::hkbClipGenerator* a_clipGenerator)
+	std::enable_if_t<std::is_same_v<KeyType, std::pair<RE::ObjectRefHandle, T>>, Conditions::IStateData*> AddStateData(Key a_key, Conditions::IStateData* a_stateData, RE::hkbClipGenerator* a_clipGenerator, bool a_bTicking)
 	{
 		WriteLocker locker(_stateDataLock);
 
-		const auto [it, bSuccess] = _stateData.try_emplace(a_key, a_key.first, a_stateData);
+		const auto [it, bSuccess] = _stateData.try_emplace(a_key, a_key.first, a_stateData, a_bTicking);
 		if (bSuccess) {
-			_keyMap[a_key.first].emplace(a_key);
+			AddToKeyMap(a_key.first, a_key);
+			OnEntryAdded(a_key, it->second);
 			return it->second.AccessData(a_clipGenerator);
 		}
 
@@ -262,13 +338,14 @@ public:
 	}
 
 	template <typename KeyType = Key>
-	std::enable_if_t<std::is_same_v<KeyType, RE::ObjectRefHandle>, Conditions::IStateData*> AddStateData(RE::ObjectRefHandle a_key, Conditions::IStateData* a_stateData, RE::hkbClipGenerator* a_clipGenerator)
+	std::enable_if_t<std::is_same_v<KeyType, RE::ObjectRefHandle>, Conditions::IStateData*> AddStateData(RE::ObjectRefHandle a_key, Conditions::IStateData* a_stateData, RE::hkbClipGenerator* a_clipGenerator, bool a_bTicking)
 	{
 		WriteLocker locker(_stateDataLock);
 
-		const auto [it, bSuccess] = _stateData.try_emplace(a_key, a_key, a_stateData);
+		const auto [it, bSuccess] = _stateData.try_emplace(a_key, a_key, a_stateData, a_bTicking);
 		if (bSuccess) {
-			_keyMap[a_key].emplace(a_key);
+			AddToKeyMap(a_key, a_key);
+			OnEntryAdded(a_key, it->second);
 			return it->second.AccessData(a_clipGenerator);
 		}
 
@@ -276,7 +353,63 @@ public:
 	}
 
 protected:
+	using Deadline = std::pair<float, Key>;
+
+	struct DeadlineCompare
+	{
+		bool operator()(const Deadline& a_lhs, const Deadline& a_rhs) const { return a_lhs.first > a_rhs.first; }
+	};
+
+	void AddToKeyMap(RE::ObjectRefHandle a_refHandle, const Key& a_key)
+	{
+		const auto [it, bInserted] = _keyMap.try_emplace(a_refHandle);
+		it->second.emplace(a_key);
+		if (bInserted) {
+			_holder->OnStateDataRefrAdded(a_refHandle);
+		}
+	}
+
+	void OnEntryAdded(const Key& a_key, StateDataContainerEntry& a_entry)
+	{
+		if (a_entry.IsTicking()) {
+			_tickingKeys.emplace(a_key);
+		} else {
+			Schedule(a_key, a_entry, a_entry.GetDeadline());
+		}
+	}
+
+	void Schedule(const Key& a_key, StateDataContainerEntry& a_entry, float a_deadline)
+	{
+		a_entry.SetScheduledDeadline(a_deadline);
+		_deadlines.emplace(a_deadline, a_key);
+	}
+
+	void EraseEntry(const Key& a_key)
+	{
+		const auto search = _stateData.find(a_key);
+		if (search == _stateData.end()) {
+			return;
+		}
+
+		if (const auto keySearch = _keyMap.find(search->second.GetRefHandle()); keySearch != _keyMap.end()) {
+			keySearch->second.erase(a_key);
+			if (keySearch->second.empty()) {
+				_holder->OnStateDataRefrRemoved(keySearch->first);
+				_keyMap.erase(keySearch);
+			}
+		}
+
+		_tickingKeys.erase(a_key);
+		_stateData.erase(search);
+	}
+
+	IStateDataContainerHolder* _holder;
+
 	mutable SharedLock _stateDataLock;
 	std::unordered_map<Key, StateDataContainerEntry, KeyHash<Key>, KeyEqual<Key>> _stateData{};
 	std::unordered_map<RE::ObjectRefHandle, std::unordered_set<Key, KeyHash<Key>, KeyEqual<Key>>> _keyMap{};
+
+	// entries that need an update every frame, the rest only get looked at once their deadline passes
+	std::unordered_set<Key, KeyHash<Key>, KeyEqual<Key>> _tickingKeys{};
+	std::priority_queue<Deadline, std::vector<Deadline>, DeadlineCompare> _deadlines{};
 };
@@ -20,6 +20,7 @@ namespace UI
 		if (ImGui::Begin("Animation Log", nullptr, windowFlags)) {
 			if (UIManager::GetSingleton().GetRefrToEvaluate() != nullptr) {
 				auto& animationLog = AnimationLog::GetSingleton();
+				animationLog.ProcessPendingEntries();
 				if (!animationLog.IsAnimationLogEmpty()) {
 					if (ImGui::BeginTable("AnimationLogTable", 1, ImGuiTableFlags_Borders)) {
 						animationLog.ForEachAnimationLogEntry([&](AnimationLogEntry& a_logEntry) {
@@ -68,7 +69,9 @@ namespace UI
 		const float filterWidth = (ImGui::GetContentRegionAvail().x - style.FramePadding.x * 2 - helpMarkerWidth * 2);
 
 		ImGui::SetNextItemWidth(filterWidth);
-		ImGui::InputTextWithHint("##filter", "Filter... (Affects new entries)", &animationLog.filter);
+		if (ImGui::InputTextWithHint("##filter", "Filter... (Affects new entries)", &animationLog.filter)) {
+			animationLog.RefreshFilter();
+		}
 		ImGui::SameLine();
 		UICommon::HelpMarker("Type a part of the log event type / animation name / path / mod name / submod name to filter the log results. You can use regex.");
 	}
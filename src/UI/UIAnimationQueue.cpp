@@ -1,4 +1,5 @@
 #include "UIAnimationQueue.h"
+#include "AnimationLoader.h"
 #include "Settings.h"
 
 namespace UI
@@ -7,7 +8,7 @@ namespace UI
 	{
 		if (Settings::bEnableAnimationQueueProgressBar && !Settings::bDisablePreloading) {
 			if (const auto animationFileManagerSingleton = RE::AnimationFileManagerSingleton::GetSingleton()) {
-				if (_fLingerTime > 0.f || animationFileManagerSingleton->queuedAnimations.size() > Settings::uQueueMinSize) {
+				if (_fLingerTime > 0.f || animationFileManagerSingleton->queuedAnimations.size() + AnimationLoader::GetSingleton().GetScheduledCount() > Settings::uQueueMinSize) {
 					return true;
 				}
 			}
@@ -19,7 +20,8 @@ namespace UI
 	void UIAnimationQueue::DrawImpl()
 	{
 		const auto animationFileManager = RE::AnimationFileManagerSingleton::GetSingleton();
-		const uint32_t queuedCount = animationFileManager->queuedAnimations.size();
+		// include the animations that are scheduled but weren't submitted to the game yet
+		const uint32_t queuedCount = animationFileManager->queuedAnimations.size() + static_cast<uint32_t>(AnimationLoader::GetSingleton().GetScheduledCount());
 
 		if (queuedCount == 0) {
 			const ImGuiIO& io = ImGui::GetIO();
@@ -4,7 +4,10 @@
 #include <imgui_stdlib.h>
 
 #include "ActiveClip.h"
+#include "AnimationLoader.h"
+#include "ConditionFactCache.h"
 #include "DetectedProblems.h"
+#include "HavokHeapStats.h"
 #include "Jobs.h"
 #include "OpenAnimationReplacer.h"
 #include "Parsing.h"
@@ -393,14 +396,39 @@ namespace UI
 			ImGui::SameLine();
 			UICommon::HelpMarker("Set the animation limit per behavior project. The game will crash if you set this too high without increasing the heap size. The game is incapable of playing animations past the upper limit set here, there's no point trying to circumvent it through the .ini file.");
 
-			constexpr uint32_t heapMin = 0x20000000;
-			constexpr uint32_t heapMax = 0x7FC00000;
+			constexpr uint32_t heapMin = Settings::uHavokHeapSizeMin;
+			constexpr uint32_t heapMax = Settings::uHavokHeapSizeMax;
 			if (ImGui::SliderScalar("Havok heap size", ImGuiDataType_U32, &Settings::uHavokHeapSize, &heapMin, &heapMax, "0x%X", ImGuiSliderFlags_AlwaysClamp)) {
 				Settings::WriteSettings();
 			}
 			ImGui::SameLine();
 			UICommon::HelpMarker("Set the havok heap size. Takes effect after restarting the game. (Vanilla value is 0x20000000)");
 
+			if (ImGui::Checkbox("Track havok heap usage", &Settings::bEnableHavokHeapTelemetry)) {
+				Settings::WriteSettings();
+			}
+			ImGui::SameLine();
+			UICommon::HelpMarker("Enable to keep track of how much of the havok heap is in use. The peak usage is logged when the game exits and remembered for the automatic heap size. Takes effect after restarting the game.");
+
+			if (ImGui::Checkbox("Automatic havok heap size", &Settings::bAutoHavokHeapSize)) {
+				Settings::WriteSettings();
+			}
+			ImGui::SameLine();
+			UICommon::HelpMarker("Enable to size the havok heap based on the peak usage recorded in the previous sessions, plus some headroom. The heap size set above is used until a session has been recorded. Implies tracking the heap usage. Takes effect after restarting the game.");
+
+			const auto& havokHeapStats = HavokHeapStats::GetSingleton();
+			if (havokHeapStats.IsTracking()) {
+				const auto snapshot = havokHeapStats.GetSnapshot();
+				constexpr double megabyte = 1024.0 * 1024.0;
+				ImGui::Text("Havok heap usage: %.1f MB, peak: %.1f MB of %.1f MB (previous sessions: %.1f MB)", static_cast<double>(snapshot.currentBytes) / megabyte, static_cast<double>(snapshot.peakBytes) / megabyte, static_cast<double>(snapshot.heapSize) / megabyte, static_cast<double>(snapshot.previousPeakBytes) / megabyte);
+				if (ImGui::TreeNode("Havok allocations by size")) {
+					for (size_t i = 0; i < HavokHeapStats::kNumSizeClasses; ++i) {
+						ImGui::Text("%s: %llu", HavokHeapStats::GetSizeClassName(i).data(), snapshot.allocationCounts[i]);
+					}
+					ImGui::TreePop();
+				}
+			}
+
 			if (ImGui::Checkbox("Async parsing", &Settings::bAsyncParsing)) {
 				Settings::WriteSettings();
 			}
@@ -420,6 +448,88 @@ namespace UI
 			ImGui::SameLine();
 			UICommon::HelpMarker("Enable to start loading default male/female behaviors in the main menu. Ignored with animation preloading disabled as there's no benefit in doing so in that case.");
 
+			ImGui::BeginDisabled(Settings::bDisablePreloading);
+			constexpr uint32_t preloadBudgetMin = 0;
+			constexpr uint32_t preloadBudgetMax = 4096;
+			if (ImGui::SliderScalar("Preloaded animations per frame", ImGuiDataType_U32, &Settings::uPreloadBudgetPerFrame, &preloadBudgetMin, &preloadBudgetMax, "%d", ImGuiSliderFlags_AlwaysClamp)) {
+				Settings::WriteSettings();
+			}
+			ImGui::EndDisabled();
+			ImGui::SameLine();
+			UICommon::HelpMarker("Set the maximum number of replacement animations submitted to the game's loading queue per frame. Animations that are likely to be used by the player or loaded actors are submitted first. Lower values keep the game's own animation loading more responsive, 0 submits everything at once.");
+
+			if (ImGui::Checkbox("Unload idle animations", &Settings::bEnableAnimationEviction)) {
+				Settings::WriteSettings();
+			}
+			ImGui::SameLine();
+			UICommon::HelpMarker("Enable to unload replacement animations that haven't been played for a while once the loaded replacements exceed the memory budget. The least recently used ones are unloaded first, and get loaded again on demand the next time they're needed.");
+
+			ImGui::BeginDisabled(!Settings::bEnableAnimationEviction);
+			constexpr uint32_t evictionBudgetMin = 64;
+			constexpr uint32_t evictionBudgetMax = 8192;
+			if (ImGui::SliderScalar("Animation memory budget", ImGuiDataType_U32, &Settings::uAnimationEvictionBudget, &evictionBudgetMin, &evictionBudgetMax, "%d MB", ImGuiSliderFlags_AlwaysClamp)) {
+				Settings::WriteSettings();
+			}
+			ImGui::SameLine();
+			UICommon::HelpMarker("Set the approximate amount of memory loaded replacement animations can take up before idle ones start getting unloaded. The size is estimated from the animation files.");
+
+			if (ImGui::SliderFloat("Idle time before unloading", &Settings::fAnimationEvictionIdleTime, 10.f, 1800.f, "%.0f s", ImGuiSliderFlags_AlwaysClamp)) {
+				Settings::WriteSettings();
+			}
+			ImGui::SameLine();
+			UICommon::HelpMarker("Set how long a replacement animation has to go unplayed before it can be unloaded.");
+
+			const auto& animationLoader = AnimationLoader::GetSingleton();
+			ImGui::Text("Loaded replacements: %zu (%.1f MB), unloaded so far: %zu", animationLoader.GetHeldCount(), static_cast<double>(animationLoader.GetHeldBytes()) / (1024.0 * 1024.0), animationLoader.GetEvictedCount());
+			ImGui::EndDisabled();
+
+			if (ImGui::Checkbox("Cache condition facts", &Settings::bEnableConditionFactCache)) {
+				if (!Settings::bEnableConditionFactCache) {
+					ConditionFactCache::GetSingleton().Clear();
+				}
+				Settings::WriteSettings();
+			}
+			ImGui::SameLine();
+			UICommon::HelpMarker("Enable to cache the results of expensive lookups done by some conditions (e.g. worn items, inventory counts, magic effects) per actor, and only refresh them when a relevant game event happens (e.g. equipping an item).");
+
+			ImGui::Spacing();
+			ImGui::Separator();
+
+			// Blending settings
+			ImGui::AlignTextToFramePadding();
+			ImGui::TextUnformatted("Blending Settings");
+			ImGui::Spacing();
+
+			if (ImGui::Checkbox("Reduce blending quality with distance", &Settings::bEnableBlendLOD)) {
+				Settings::WriteSettings();
+			}
+			ImGui::SameLine();
+			UICommon::HelpMarker("Enable to reduce the cost of blending between animations (e.g. on interrupt) for actors that are far away from the camera or off screen. Only the first few bones are blended for those, and the blend is skipped entirely for actors very far away. The player is never affected.");
+
+			ImGui::BeginDisabled(!Settings::bEnableBlendLOD);
+			if (ImGui::SliderFloat("Reduced quality distance", &Settings::fBlendLODReducedDistance, 0.f, 16384.f, "%.0f", ImGuiSliderFlags_AlwaysClamp)) {
+				Settings::fBlendLODHardCutDistance = std::max(Settings::fBlendLODHardCutDistance, Settings::fBlendLODReducedDistance);
+				Settings::WriteSettings();
+			}
+			ImGui::SameLine();
+			UICommon::HelpMarker("Distance from the camera, in game units, after which only the first bones of the skeleton are blended.");
+
+			if (ImGui::SliderFloat("No blending distance", &Settings::fBlendLODHardCutDistance, 0.f, 16384.f, "%.0f", ImGuiSliderFlags_AlwaysClamp)) {
+				Settings::fBlendLODReducedDistance = std::min(Settings::fBlendLODReducedDistance, Settings::fBlendLODHardCutDistance);
+				Settings::WriteSettings();
+			}
+			ImGui::SameLine();
+			UICommon::HelpMarker("Distance from the camera, in game units, after which animations switch instantly without blending.");
+
+			constexpr uint32_t trackCountMin = 1;
+			constexpr uint32_t trackCountMax = 128;
+			if (ImGui::SliderScalar("Reduced quality bone count", ImGuiDataType_U32, &Settings::uBlendLODReducedTrackCount, &trackCountMin, &trackCountMax, "%d", ImGuiSliderFlags_AlwaysClamp)) {
+				Settings::WriteSettings();
+			}
+			ImGui::SameLine();
+			UICommon::HelpMarker("Number of bones that are still blended at reduced quality. The skeleton is ordered from the root outwards, so the remaining bones are usually fingers, face and other small details.");
+			ImGui::EndDisabled();
+
 			ImGui::Spacing();
 			ImGui::Separator();
 
@@ -588,7 +698,7 @@ namespace UI
 				Settings::WriteSettings();
 			}
 			ImGui::SameLine();
-			UICommon::HelpMarker("Set to disable preloading all animations when the behavior is first loaded. This is not recommended, and the setting has been proven to cause some differences in animation behavior.");
+			UICommon::HelpMarker("Set to disable preloading all animations when the behavior is first loaded. Replacement animations are then loaded on demand the first time their conditions pass, and the original animation keeps playing until the replacement is loaded. This saves memory in large setups, but replacements will start a bit late the first time they play, and the setting has been proven to cause some differences in animation behavior.");
 
 			if (ImGui::Checkbox("Increase animation limit", &Settings::bIncreaseAnimationLimit)) {
 				Settings::ClampAnimLimit();
@@ -1299,6 +1409,28 @@ namespace UI
 				const std::string blendTimeLabel = "Custom blend time on interrupt##" + std::to_string(reinterpret_cast<std::uintptr_t>(a_replacerMod)) + std::to_string(reinterpret_cast<std::uintptr_t>(a_subMod)) + "blendTimeOnInterrupt";
 				const std::string blendTimeTooltip = "Sets custom blend time between an animation from this submod and a new one on interrupt.";
 				drawBlendTimeOption(CustomBlendType::kInterrupt, hasCustomBlendTimeLabel, blendTimeLabel, blendTimeTooltip);
+
+				// Submod interrupt evaluation interval
+				const std::string intervalLabel = "Interrupt check interval##" + std::to_string(reinterpret_cast<std::uintptr_t>(a_replacerMod)) + std::to_string(reinterpret_cast<std::uintptr_t>(a_subMod)) + "interruptEvaluationInterval";
+				const std::string intervalTooltip = "Sets the minimum time between checking the conditions of an animation from this submod for an interrupt. 0 means every frame. The conditions are still checked sooner if something they might depend on changes (e.g. equipment, inventory or magic effects).";
+				if (_editMode != ConditionEditMode::kNone) {
+					float tempInterval = a_subMod->GetInterruptEvaluationInterval();
+					ImGui::SetNextItemWidth(200.f);
+					if (ImGui::SliderFloat(intervalLabel.data(), &tempInterval, 0.f, 1.f, "%.2f s", ImGuiSliderFlags_AlwaysClamp)) {
+						a_subMod->SetInterruptEvaluationInterval(tempInterval);
+						a_subMod->SetDirty(true);
+					}
+					ImGui::SameLine();
+					UICommon::HelpMarker(intervalTooltip.data());
+				} else if (a_subMod->GetInterruptEvaluationInterval() > 0.f) {
+					ImGui::BeginDisabled();
+					float tempInterval = a_subMod->GetInterruptEvaluationInterval();
+					ImGui::SetNextItemWidth(200.f);
+					ImGui::SliderFloat(intervalLabel.data(), &tempInterval, 0.f, 1.f, "%.2f s", ImGuiSliderFlags_AlwaysClamp);
+					ImGui::EndDisabled();
+					ImGui::SameLine();
+					UICommon::HelpMarker(intervalTooltip.data());
+				}
 			}
 
 			// Submod replace on loop
@@ -2,12 +2,48 @@
 
 #include "BaseConditions.h"
 #include "Offsets.h"
+#include "ReplacerMods.h"
 #include "Settings.h"
 
 #include <ranges>
 
 namespace Utils
 {
+	namespace
+	{
+		ExclusiveLock randomStreamsLock;
+		std::unordered_map<uint64_t, RandomGenerator> randomStreams;
+	}
+
+	RandomGenerator& GetThreadRandomGenerator()
+	{
+		thread_local RandomGenerator generator(std::random_device{}() ^ (static_cast<uint64_t>(std::hash<std::thread::id>{}(std::this_thread::get_id())) << 32));
+		return generator;
+	}
+
+	float GetRandomFloat(float a_min, float a_max, const RE::TESObjectREFR* a_refr, const SubMod* a_subMod)
+	{
+		if (!Settings::bDeterministicRandom) {
+			return GetRandomFloat(a_min, a_max);
+		}
+
+		// form IDs and submod paths stay the same between sessions, unlike pointers
+		uint64_t streamKey = a_refr ? a_refr->GetFormID() : 0;
+		if (a_subMod) {
+			boost::hash_combine(streamKey, std::hash<std::string_view>{}(a_subMod->GetPath()));
+		}
+
+		Locker locker(randomStreamsLock);
+		auto [it, bInserted] = randomStreams.try_emplace(streamKey, Settings::uDeterministicRandomSeed ^ streamKey);
+		return it->second.GetFloat(a_min, a_max);
+	}
+
+	void ResetRandomStreams()
+	{
+		Locker locker(randomStreamsLock);
+		randomStreams.clear();
+	}
+
 	std::string_view TrimWhitespace(const std::string_view a_s)
 	{
 		const auto startPos = a_s.find_first_not_of(" "sv);
@@ -6,6 +6,8 @@
 
 #include <unordered_set>
 
+class SubMod;
+
 namespace Utils
 {
 	enum class TargetType : int32_t
@@ -43,7 +45,54 @@ namespace Utils
 	[[nodiscard]] std::string GetFormKeywords(RE::TESForm* a_form);
 	[[nodiscard]] std::string GetFormKeywords(RE::BGSKeywordForm* a_keywordForm);
 
-	[[nodiscard]] inline float GetRandomFloat(float a_min, float a_max) { return effolkronium::random_static::get<float>(a_min, a_max); }
+	// xoshiro128+, small enough to give every thread (and every deterministic stream) its own state
+	class RandomGenerator
+	{
+	public:
+		explicit RandomGenerator(uint64_t a_seed) { Seed(a_seed); }
+
+		void Seed(uint64_t a_seed)
+		{
+			// splitmix64 to spread the seed over the whole state
+			for (size_t i = 0; i < 4; i += 2) {
+				a_seed += 0x9E3779B97F4A7C15;
+				uint64_t z = a_seed;
+				z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+				z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+				z ^= z >> 31;
+				_state[i] = static_cast<uint32_t>(z);
+				_state[i + 1] = static_cast<uint32_t>(z >> 32);
+			}
+		}
+
+		uint32_t Next()
+		{
+			const uint32_t result = _state[0] + _state[3];
+			const uint32_t t = _state[1] << 9;
+
+			_state[2] ^= _state[0];
+			_state[3] ^= _state[1];
+			_state[1] ^= _state[2];
+			_state[0] ^= _state[3];
+			_state[2] ^= t;
+			_state[3] = std::rotl(_state[3], 11);
+
+			return result;
+		}
+
+		// uses the top 24 bits, which is all a float can hold, so the result is in [a_min, a_max)
+		float GetFloat(float a_min, float a_max) { return a_min + (a_max - a_min) * (static_cast<float>(Next() >> 8) * 0x1.0p-24f); }
+
+	private:
+		uint32_t _state[4];
+	};
+
+	[[nodiscard]] RandomGenerator& GetThreadRandomGenerator();
+	[[nodiscard]] inline float GetRandomFloat(float a_min, float a_max) { return GetThreadRandomGenerator().GetFloat(a_min, a_max); }
+
+	// same as above, unless deterministic random is enabled - then every refr + submod pair draws from its own seeded stream, so a replay from the same save picks the same values
+	[[nodiscard]] float GetRandomFloat(float a_min, float a_max, const RE::TESObjectREFR* a_refr, const SubMod* a_subMod);
+	void ResetRandomStreams();
 
 	[[nodiscard]] inline RE::Actor* GetActorFromHkbCharacter(RE::hkbCharacter* a_hkbCharacter)
 	{
@@ -179,35 +228,4 @@ namespace Utils
 	[[nodiscard]] RE::hkVector4 Mix(const RE::hkVector4& a_vecA, const RE::hkVector4& a_vecB, float a_alpha);
 
 	[[nodiscard]] bool GetSurfaceNormal(RE::TESObjectREFR* a_refr, RE::hkVector4& a_outVector, bool a_bUseNavmesh);
-
-	template <class T>
-	class UniqueQueue
-	{
-	public:
-		void push(const T& a_value)
-		{
-			if (!_set.contains(a_value)) {
-				_queue.push(a_value);
-				_set.emplace(a_value);
-			}
-		}
-
-		void pop()
-		{
-			if (!_queue.empty()) {
-				_set.erase(_queue.front());
-				_queue.pop();
-			}
-		}
-
-		[[nodiscard]] T front() { return _queue.front(); }
-
-		[[nodiscard]] T back() { return _queue.back(); }
-
-		bool empty() const { return _queue.empty(); }
-
-	private:
-		std::queue<T> _queue;
-		std::set<T, std::owner_less<T>> _set;
-	};
 }
@@ -33,10 +33,10 @@ void Variant::ResetSettings()
 	_bPlayOnce = false;
 }
 
-uint16_t Variants::GetVariantIndex(Variant*& a_outVariant) const
+uint16_t Variants::GetVariantIndex(const RE::TESObjectREFR* a_refr, Variant*& a_outVariant) const
 {
 	// no active clip, so only supports random variants
-	const float randomWeight = Utils::GetRandomFloat(0.f, 1.f);
+	const float randomWeight = Utils::GetRandomFloat(0.f, 1.f, a_refr, GetParentSubMod());
 
 	return GetVariantIndex(a_outVariant, randomWeight);
 }
@@ -62,14 +62,14 @@ uint16_t Variants::GetVariantIndex(ActiveClip* a_activeClip, Variant*& a_outVari
 			ReadLocker locker(_lock);
 
 			if (!_sequentialVariants.empty()) {
-				auto nextSequentialVariant = stateData->GetNextSequentialVariant(a_activeClip->GetClipGenerator(), this);
-				if (!stateData->HasPlayedOnce(a_activeClip->GetClipGenerator(), nextSequentialVariant, this)) {
+				auto nextSequentialVariant = stateData->GetNextSequentialVariant(a_activeClip, this);
+				if (!stateData->HasPlayedOnce(a_activeClip, nextSequentialVariant, this)) {
 					a_outVariant = _sequentialVariants[nextSequentialVariant];
 					return a_outVariant->GetIndex();
 				}
 			}
 
-			const float randomWeight = stateData->GetRandomFloat();
+			const float randomWeight = stateData->GetRandomFloat(a_activeClip, this);
 
 			const auto it = std::ranges::lower_bound(_cumulativeWeights, randomWeight);
 			const auto i = std::distance(_cumulativeWeights.begin(), it);
@@ -78,7 +78,7 @@ uint16_t Variants::GetVariantIndex(ActiveClip* a_activeClip, Variant*& a_outVari
 		}
 	case VariantMode::kSequential:
 		{
-			a_outVariant = _sequentialVariants[stateData->GetNextSequentialVariant(a_activeClip->GetClipGenerator(), this)];
+			a_outVariant = _sequentialVariants[stateData->GetNextSequentialVariant(a_activeClip, this)];
 			return a_outVariant->GetIndex();
 		}
 	}
@@ -246,6 +246,23 @@ Variant* Variants::GetActiveVariant(size_t a_variantIndex) const
 	return nullptr;
 }
 
+const Variant* Variants::GetLikelyNextVariant(const Variant* a_variant) const
+{
+	ReadLocker locker(_lock);
+
+	const auto it = std::ranges::find(_sequentialVariants, a_variant);
+	if (it == _sequentialVariants.end()) {
+		return nullptr;
+	}
+
+	if (std::next(it) != _sequentialVariants.end()) {
+		return *std::next(it);
+	}
+
+	// in random mode the play once variants don't wrap around, a random one follows instead
+	return _variantMode == VariantMode::kSequential ? _sequentialVariants.front() : nullptr;
+}
+
 VariantStateData* Variants::CreateVariantStateData(ActiveClip* a_activeClip) const
 {
 	const auto newStateData = static_cast<VariantStateData*>(VariantStateData::Create());
@@ -324,37 +341,37 @@ bool VariantStateData::IsActive() const
 	return false;
 }
 
-void VariantStateData::SetActiveVariant(RE::hkbClipGenerator* a_clipGenerator, bool a_bActive)
+void VariantStateData::SetActiveVariant(const ActiveClip* a_activeClip, bool a_bActive)
 {
 	if (a_bActive) {
 		WriteLocker locker(_dataLock);
 
-		auto [it, bAdded] = _activeVariants.try_emplace(a_clipGenerator->name.data(), VariantClipData());
-		if (!bAdded) {
+		if (const auto variantClipData = FindVariantClipData(a_activeClip->GetClipNameID())) {
 			// already exists, set active and reset the timer
-			it->second.timeInactive = 0.f;
-			it->second.bActive = true;
+			variantClipData->timeInactive = 0.f;
+			variantClipData->bActive = true;
+		} else {
+			_activeVariants.emplace_back(a_activeClip->GetClipNameID(), VariantClipData());
 		}
 	} else {
 		ReadLocker locker(_dataLock);
 
-		auto search = _activeVariants.find(a_clipGenerator->name.data());
-		if (search != _activeVariants.end()) {
-			search->second.bActive = false;
+		if (const auto variantClipData = FindVariantClipData(a_activeClip->GetClipNameID())) {
+			variantClipData->bActive = false;
 		}
 	}
 }
 
-float VariantStateData::GetRandomFloat()
+float VariantStateData::GetRandomFloat(const ActiveClip* a_activeClip, const Variants* a_variants)
 {
 	if (!_randomFloat.has_value()) {
-		_randomFloat = Utils::GetRandomFloat(0.f, 1.f);
+		_randomFloat = Utils::GetRandomFloat(0.f, 1.f, a_activeClip->GetRefr(), a_variants->GetParentSubMod());
 	}
 
 	return *_randomFloat;
 }
 
-bool VariantStateData::HasPlayedOnce(RE::hkbClipGenerator* a_clipGenerator, size_t a_index, const Variants* a_variants) const
+bool VariantStateData::HasPlayedOnce(const ActiveClip* a_activeClip, size_t a_index, const Variants* a_variants) const
 {
 	ReadLocker locker(_dataLock);
 
@@ -362,25 +379,19 @@ bool VariantStateData::HasPlayedOnce(RE::hkbClipGenerator* a_clipGenerator, size
 		if (_sharedPlayedHistory.size() > a_index) {
 			return _sharedPlayedHistory[a_index].HasPlayed();
 		}
-	} else {
-		auto search = _activeVariants.find(a_clipGenerator->name.data());
-		if (search != _activeVariants.end()) {
-			if (search->second.playedHistory.size() > a_index) {
-				return search->second.playedHistory[a_index];
-			}
-		}
+	} else if (const auto variantClipData = FindVariantClipData(a_activeClip->GetClipNameID())) {
+		return variantClipData->playedHistory.Test(a_index);
 	}
 
 	return false;
 }
 
-size_t VariantStateData::GetNextSequentialVariant(RE::hkbClipGenerator* a_clipGenerator, const Variants* a_variants)
+size_t VariantStateData::GetNextSequentialVariant(const ActiveClip* a_activeClip, const Variants* a_variants)
 {
 	ReadLocker locker(_dataLock);
 
-	auto search = _activeVariants.find(a_clipGenerator->name.data());
-	if (search != _activeVariants.end()) {
-		auto& variantClipData = search->second;
+	if (const auto search = FindVariantClipData(a_activeClip->GetClipNameID())) {
+		auto& variantClipData = *search;
 		variantClipData.nextSequentialVariant = variantClipData.nextSequentialVariant % a_variants->GetSequentialVariantCount();
 
 		if (a_variants->ShouldSharePlayedHistory()) {
@@ -393,7 +404,7 @@ size_t VariantStateData::GetNextSequentialVariant(RE::hkbClipGenerator* a_clipGe
 				}
 
 				// if we're here, all sequential variants have been played, and we should clear the history
-				variantClipData.playedHistory.clear();
+				variantClipData.playedHistory.Clear();
 				variantClipData.nextSequentialVariant = 0;
 			}
 		}
@@ -404,13 +415,12 @@ size_t VariantStateData::GetNextSequentialVariant(RE::hkbClipGenerator* a_clipGe
 	return 0;
 }
 
-bool VariantStateData::IsAtBeginningOfSequence(RE::hkbClipGenerator* a_clipGenerator, const Variants* a_variants) const
+bool VariantStateData::IsAtBeginningOfSequence(const ActiveClip* a_activeClip, const Variants* a_variants) const
 {
 	ReadLocker locker(_dataLock);
 
-	auto search = _activeVariants.find(a_clipGenerator->name.data());
-	if (search != _activeVariants.end()) {
-		auto& variantClipData = search->second;
+	if (const auto search = FindVariantClipData(a_activeClip->GetClipNameID())) {
+		const auto& variantClipData = *search;
 		const auto nextSequentialVariant = variantClipData.nextSequentialVariant;
 		if (nextSequentialVariant == 0) {
 			return true;
@@ -434,17 +444,19 @@ bool VariantStateData::CheckLeadingClip(const Variants* a_variants, ActiveClip*
 {
 	if (a_variants->GetVariantStateScope() > Conditions::StateDataScope::kLocal) {
 		if (a_activeClip) {
-			// remove invalid pointers
-			while (!_clipPriorityQueue.empty()) {
-				if (!_clipPriorityQueue.front().lock()) {
-					_clipPriorityQueue.pop();
-				} else {
-					break;
-				}
+			// remove invalid pointers from the front
+			const auto firstAlive = std::ranges::find_if(_clipPriorityQueue, [](const auto& a_clip) { return !a_clip.expired(); });
+			_clipPriorityQueue.erase(_clipPriorityQueue.begin(), firstAlive);
+
+			// only queue each clip once
+			const auto clipPtr = a_activeClip->getptr();
+			const bool bQueued = std::ranges::any_of(_clipPriorityQueue, [&](const auto& a_clip) {
+				return !a_clip.owner_before(clipPtr) && !clipPtr.owner_before(a_clip);
+			});
+			if (!bQueued) {
+				_clipPriorityQueue.emplace_back(clipPtr);
 			}
 
-			_clipPriorityQueue.push(a_activeClip->getptr());
-
 			if (!_clipPriorityQueue.empty()) {
 				if (auto leadingClip = _clipPriorityQueue.front().lock()) {
 					return leadingClip.get() == a_activeClip;
@@ -458,7 +470,7 @@ bool VariantStateData::CheckLeadingClip(const Variants* a_variants, ActiveClip*
 
 void VariantStateData::OnStartVariant(const Variants* a_variants, Variant* a_variant, ActiveClip* a_activeClip)
 {
-	SetActiveVariant(a_activeClip->GetClipGenerator(), true);
+	SetActiveVariant(a_activeClip, true);
 
 	/*if (!CheckLeadingClip(a_variants, a_activeClip)) {
 		return;
@@ -467,9 +479,8 @@ void VariantStateData::OnStartVariant(const Variants* a_variants, Variant* a_var
 	if (a_variant->ShouldPlayOnce()) {
 		ReadLocker locker(_dataLock);
 
-		auto search = _activeVariants.find(a_activeClip->GetClipGenerator()->name.data());
-		if (search != _activeVariants.end()) {
-			auto& variantClipData = search->second;
+		if (const auto search = FindVariantClipData(a_activeClip->GetClipNameID())) {
+			auto& variantClipData = *search;
 			auto nextSequentialVariant = variantClipData.nextSequentialVariant;
 
 			if (a_variants->ShouldSharePlayedHistory()) {
@@ -483,15 +494,7 @@ void VariantStateData::OnStartVariant(const Variants* a_variants, Variant* a_var
 
 				_sharedPlayedHistory[nextSequentialVariant].SetPlayed();
 			} else {
-				if (variantClipData.playedHistory.empty()) {
-					// initialize the vector
-					variantClipData.playedHistory.resize(std::max(nextSequentialVariant + 1, a_variants->GetSequentialVariantCount()), false);
-				} else if (variantClipData.playedHistory.size() <= nextSequentialVariant) {
-					// resize the vector
-					variantClipData.playedHistory.resize(nextSequentialVariant + 1, false);
-				}
-
-				variantClipData.playedHistory[nextSequentialVariant] = true;
+				variantClipData.playedHistory.Set(nextSequentialVariant);
 			}
 		}
 	}
@@ -503,7 +506,7 @@ void VariantStateData::OnStartVariant(const Variants* a_variants, Variant* a_var
 
 void VariantStateData::OnEndVariant([[maybe_unused]] const Variants* a_variants, ActiveClip* a_activeClip)
 {
-	SetActiveVariant(a_activeClip->GetClipGenerator(), false);
+	SetActiveVariant(a_activeClip, false);
 }
 
 void VariantStateData::IterateSequence(const Variants* a_variants, ActiveClip* a_activeClip)
@@ -512,9 +515,8 @@ void VariantStateData::IterateSequence(const Variants* a_variants, ActiveClip* a
 
 	ReadLocker locker(_dataLock);
 
-	auto search = _activeVariants.find(a_activeClip->GetClipGenerator()->name.data());
-	if (search != _activeVariants.end()) {
-		auto& variantClipData = search->second;
+	if (const auto search = FindVariantClipData(a_activeClip->GetClipNameID())) {
+		auto& variantClipData = *search;
 
 		//iterate the index
 		++variantClipData.nextSequentialVariant;
@@ -531,19 +533,31 @@ void VariantStateData::IterateSequence(const Variants* a_variants, ActiveClip* a
 				if (_sharedPlayedHistory.size() <= variantClipData.nextSequentialVariant || !_sharedPlayedHistory[variantClipData.nextSequentialVariant].HasPlayed()) {
 					return;
 				}
-			} else if (variantClipData.playedHistory.size() <= variantClipData.nextSequentialVariant || !variantClipData.playedHistory[variantClipData.nextSequentialVariant]) {
+			} else if (!variantClipData.playedHistory.Test(variantClipData.nextSequentialVariant)) {
 				return;
 			}
 		}
 
 		if (a_variants->GetVariantMode() == VariantMode::kSequential) {
 			// if we're here, all sequential variants have been played, and we should clear the history
-			variantClipData.playedHistory.clear();
+			variantClipData.playedHistory.Clear();
 			variantClipData.nextSequentialVariant = 0;
 		}
 	}
 }
 
+VariantClipData* VariantStateData::FindVariantClipData(uint32_t a_clipNameID)
+{
+	const auto it = std::ranges::find(_activeVariants, a_clipNameID, &decltype(_activeVariants)::value_type::first);
+	return it != _activeVariants.end() ? &it->second : nullptr;
+}
+
+const VariantClipData* VariantStateData::FindVariantClipData(uint32_t a_clipNameID) const
+{
+	const auto it = std::ranges::find(_activeVariants, a_clipNameID, &decltype(_activeVariants)::value_type::first);
+	return it != _activeVariants.end() ? &it->second : nullptr;
+}
+
 bool VariantStateDataContainer::UpdateData(float a_deltaTime)
 {
 	bool bActive = false;
@@ -661,11 +675,18 @@ void VariantStateDataContainer::Clear()
 {
 	{
 		WriteLocker locker(_localMapLock);
+		// cleared one by one first so the holder is told which refs lost their data
+		for (auto& container : _localVariantStateData | std::views::values) {
+			container.Clear();
+		}
 		_localVariantStateData.clear();
 	}
 
 	{
 		WriteLocker locker(_subModMapLock);
+		for (auto& container : _subModVariantStateData | std::views::values) {
+			container.Clear();
+		}
 		_subModVariantStateData.clear();
 	}
 	_replacerModVariantStateData.Clear();
@@ -703,15 +724,15 @@ Conditions::IStateData* VariantStateDataContainer::AddStateData(RE::ObjectRefHan
 	case Conditions::StateDataScope::kLocal:
 		{
 			WriteLocker locker(_localMapLock);
-			return _localVariantStateData[a_clipGenerator].AddStateData(a_key, a_stateData, a_clipGenerator);
+			return _localVariantStateData.try_emplace(a_clipGenerator, _holder).first->second.AddStateData(a_key, a_stateData, a_clipGenerator, true);
 		}
 	case Conditions::StateDataScope::kSubMod:
 		{
 			WriteLocker locker(_subModMapLock);
-			return _subModVariantStateData[a_variants->GetParentSubMod()].AddStateData(a_key, a_stateData, a_clipGenerator);
+			return _subModVariantStateData.try_emplace(a_variants->GetParentSubMod(), _holder).first->second.AddStateData(a_key, a_stateData, a_clipGenerator, true);
 		}
 	case Conditions::StateDataScope::kReplacerMod:
-		return _replacerModVariantStateData.AddStateData(a_key, a_stateData, a_clipGenerator);
+		return _replacerModVariantStateData.AddStateData(a_key, a_stateData, a_clipGenerator, true);
 	}
 
 	return nullptr;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "API/OpenAnimationReplacer-ConditionTypes.h"
+#include "ObjectPool.h"
 #include "Settings.h"
 #include "StateDataContainer.h"
 #include "Utils.h"
@@ -60,7 +61,7 @@ public:
 		UpdateVariantCache();
 	}
 
-	uint16_t GetVariantIndex(Variant*& a_outVariant) const;
+	uint16_t GetVariantIndex(const RE::TESObjectREFR* a_refr, Variant*& a_outVariant) const;
 	uint16_t GetVariantIndex(Variant*& a_outVariant, float a_randomWeight) const;
 	uint16_t GetVariantIndex(ActiveClip* a_activeClip, Variant*& a_outVariant) const;
 	void UpdateVariantCache();
@@ -98,6 +99,8 @@ public:
 	size_t GetSequentialVariantCount() const;
 
 	Variant* GetActiveVariant(size_t a_variantIndex) const;
+	// the variant that will most likely play after the given one, if it can be predicted (sequential variants only)
+	[[nodiscard]] const Variant* GetLikelyNextVariant(const Variant* a_variant) const;
 
 protected:
 	VariantStateData* CreateVariantStateData(ActiveClip* a_activeClip) const;
@@ -123,6 +126,47 @@ protected:
 	Conditions::StateDataScope _variantStateScope = Conditions::StateDataScope::kLocal;
 };
 
+// played flags for the sequential variants of a clip, the first 64 fit inline so the common case never allocates
+class PlayedHistory
+{
+public:
+	[[nodiscard]] bool Test(size_t a_index) const
+	{
+		if (a_index < kInlineBits) {
+			return _bits.test(a_index);
+		}
+
+		const size_t overflowIndex = a_index - kInlineBits;
+		return _overflow.size() > overflowIndex && _overflow[overflowIndex];
+	}
+
+	void Set(size_t a_index)
+	{
+		if (a_index < kInlineBits) {
+			_bits.set(a_index);
+			return;
+		}
+
+		const size_t overflowIndex = a_index - kInlineBits;
+		if (_overflow.size() <= overflowIndex) {
+			_overflow.resize(overflowIndex + 1, false);
+		}
+		_overflow[overflowIndex] = true;
+	}
+
+	void Clear()
+	{
+		_bits.reset();
+		_overflow.clear();
+	}
+
+private:
+	static constexpr size_t kInlineBits = 64;
+
+	std::bitset<kInlineBits> _bits{};
+	std::vector<bool> _overflow{};
+};
+
 struct VariantClipData
 {
 	void OnActive()
@@ -142,7 +186,7 @@ struct VariantClipData
 	bool bExpired = false;
 	size_t nextSequentialVariant = 0;
 	float timeInactive = 0.f;
-	std::vector<bool> playedHistory{};
+	PlayedHistory playedHistory{};
 };
 
 struct SharedPlayedHistoryEntry
@@ -163,7 +207,7 @@ private:
 	uint32_t _timestamp = 0;
 };
 
-class VariantStateData : public Conditions::IStateData
+class VariantStateData : public Conditions::IStateData, public PoolAllocated<VariantStateData>
 {
 public:
 	static IStateData* Create() { return new VariantStateData(); }
@@ -175,13 +219,13 @@ public:
 	bool ShouldResetOnLoopOrEcho(RE::hkbClipGenerator* a_clipGenerator, bool a_bIsEcho) const override;
 
 	bool IsActive() const;
-	void SetActiveVariant(RE::hkbClipGenerator* a_clipGenerator, bool a_bActive);
+	void SetActiveVariant(const ActiveClip* a_activeClip, bool a_bActive);
 
-	float GetRandomFloat();
-	bool HasPlayedOnce(RE::hkbClipGenerator* a_clipGenerator, size_t a_index, const Variants* a_variants) const;
-	size_t GetNextSequentialVariant(RE::hkbClipGenerator* a_clipGenerator, const Variants* a_variants);
+	float GetRandomFloat(const ActiveClip* a_activeClip, const Variants* a_variants);
+	bool HasPlayedOnce(const ActiveClip* a_activeClip, size_t a_index, const Variants* a_variants) const;
+	size_t GetNextSequentialVariant(const ActiveClip* a_activeClip, const Variants* a_variants);
 
-	bool IsAtBeginningOfSequence(RE::hkbClipGenerator* a_clipGenerator, const Variants* a_variants) const;
+	bool IsAtBeginningOfSequence(const ActiveClip* a_activeClip, const Variants* a_variants) const;
 
 	bool IsLocalScope() const { return _bIsLocalScope; }
 	bool CheckLeadingClip(const Variants* a_variants, ActiveClip* a_activeClip) const;
@@ -191,11 +235,16 @@ public:
 	void IterateSequence(const Variants* a_variants, ActiveClip* a_activeClip);
 
 protected:
+	[[nodiscard]] VariantClipData* FindVariantClipData(uint32_t a_clipNameID);
+	[[nodiscard]] const VariantClipData* FindVariantClipData(uint32_t a_clipNameID) const;
+
 	mutable SharedLock _dataLock;
-	std::unordered_map<std::string, VariantClipData, KeyHash<std::string>, KeyEqual<std::string>> _activeVariants{};
+	// keyed by the interned clip generator name, there's usually only a handful of clips per state data so a linear search beats hashing
+	std::vector<std::pair<uint32_t, VariantClipData>> _activeVariants{};
 	std::vector<SharedPlayedHistoryEntry> _sharedPlayedHistory{};
 
-	mutable Utils::UniqueQueue<std::weak_ptr<ActiveClip>> _clipPriorityQueue{};
+	// clips in the order they started playing, the first one that's still alive leads the shared state
+	mutable std::vector<std::weak_ptr<ActiveClip>> _clipPriorityQueue{};
 	bool _bShouldResetRandomOnLoopOrEcho = false;
 	bool _bIsLocalScope = true;
 
@@ -208,6 +257,10 @@ protected:
 struct VariantStateDataContainer
 {
 public:
+	explicit VariantStateDataContainer(IStateDataContainerHolder* a_holder) :
+		_holder(a_holder), _replacerModVariantStateData(a_holder)
+	{}
+
 	bool UpdateData(float a_deltaTime);
 	bool OnLoopOrEcho(RE::ObjectRefHandle a_refHandle, ActiveClip* a_activeClip, bool a_bIsEcho);
 	bool ClearRefrData(RE::ObjectRefHandle a_refHandle);
@@ -216,7 +269,9 @@ public:
 	Conditions::IStateData* AddStateData(RE::ObjectRefHandle a_key, Conditions::IStateData* a_stateData, RE::hkbClipGenerator* a_clipGenerator, const Variants* a_variants);
 
 protected:
-	StateDataContainer<> _replacerModVariantStateData{};
+	IStateDataContainerHolder* _holder;
+
+	StateDataContainer<> _replacerModVariantStateData;
 
 	mutable SharedLock _subModMapLock;
 	std::unordered_map<SubMod*, StateDataContainer<>> _subModVariantStateData{};
@@ -1,4 +1,7 @@
+#include "ConditionFactCache.h"
+#include "HavokHeapStats.h"
 #include "Hooks.h"
+#include "ObjectPool.h"
 #include "OpenAnimationReplacer.h"
 #include "Settings.h"
 #include "UI/UIManager.h"
@@ -17,6 +20,14 @@ void MessageHandler(SKSE::MessagingInterface::Message* a_msg)
 	case SKSE::MessagingInterface::kDataLoaded:
 		OpenAnimationReplacer::GetSingleton().OnDataLoaded();
 		break;
+	case SKSE::MessagingInterface::kPostLoadGame:
+		ConditionFactCache::GetSingleton().Clear();
+		Utils::ResetRandomStreams();
+		ObjectPool::LogStats();
+		break;
+	case SKSE::MessagingInterface::kSaveGame:
+		HavokHeapStats::GetSingleton().WriteHistoryToDisk();
+		break;
 	case SKSE::MessagingInterface::kPostLoad:
 		// check if DAR is present
 		if (GetModuleHandle("DynamicAnimationReplacer.dll")) {
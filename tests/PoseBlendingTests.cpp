@@ -0,0 +1,206 @@
+#include "PoseBlending.h"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string_view>
+#include <vector>
+
+// checks that the SSE pose blend matches the scalar reference bit for bit over random pose stacks
+// run with --benchmark to time both versions on a character sized skeleton instead
+namespace
+{
+	struct alignas(16) Transform
+	{
+		float values[PoseBlending::kFloatsPerTransform];
+	};
+
+	using Pose = std::vector<Transform>;
+
+	using BlendFunc = void (*)(const float* const*, const uint32_t*, const float*, size_t, uint32_t, float*);
+
+	struct PoseStack
+	{
+		std::vector<Pose> poses;
+		std::vector<const float*> posePointers;
+		std::vector<uint32_t> trackCounts;
+		std::vector<float> amounts;
+		Pose basePose;
+		uint32_t numTracks;
+	};
+
+	void RandomizeRotation(std::mt19937& a_rng, float* a_outRotation)
+	{
+		std::normal_distribution<float> distribution;
+
+		float lengthSquared = 0.f;
+		for (size_t i = 0; i < 4; ++i) {
+			a_outRotation[i] = distribution(a_rng);
+			lengthSquared += a_outRotation[i] * a_outRotation[i];
+		}
+
+		const float invLength = 1.f / std::sqrt(lengthSquared);
+		for (size_t i = 0; i < 4; ++i) {
+			a_outRotation[i] *= invLength;
+		}
+	}
+
+	Pose MakeRandomPose(std::mt19937& a_rng, uint32_t a_numTracks)
+	{
+		std::uniform_real_distribution<float> translationDistribution(-100.f, 100.f);
+		std::uniform_real_distribution<float> scaleDistribution(0.5f, 2.f);
+
+		Pose pose(a_numTracks);
+		for (auto& transform : pose) {
+			for (size_t i = 0; i < 4; ++i) {
+				transform.values[i] = translationDistribution(a_rng);
+				transform.values[8 + i] = scaleDistribution(a_rng);
+			}
+			RandomizeRotation(a_rng, transform.values + 4);
+		}
+
+		return pose;
+	}
+
+	PoseStack MakeRandomStack(std::mt19937& a_rng, uint32_t a_numTracks, size_t a_numPoses)
+	{
+		std::uniform_real_distribution<float> amountDistribution(0.f, 1.f);
+		std::uniform_int_distribution<uint32_t> trackCountDistribution(a_numTracks / 2, a_numTracks);
+		std::uniform_int_distribution<int> caseDistribution(0, 9);
+
+		PoseStack stack;
+		stack.numTracks = a_numTracks;
+		stack.basePose = MakeRandomPose(a_rng, a_numTracks);
+
+		for (size_t i = 0; i < a_numPoses; ++i) {
+			auto& pose = stack.poses.emplace_back(MakeRandomPose(a_rng, a_numTracks));
+
+			// some poses are missing tracks, like partial skeletons
+			stack.trackCounts.emplace_back(caseDistribution(a_rng) < 7 ? a_numTracks : trackCountDistribution(a_rng));
+
+			float amount = amountDistribution(a_rng);
+			switch (caseDistribution(a_rng)) {
+			case 0:
+				amount = 0.f;
+				break;
+			case 1:
+				amount = 1.f;
+				break;
+			case 2:
+				// the same rotation in the opposite hemisphere
+				if (i > 0) {
+					for (uint32_t track = 0; track < a_numTracks; ++track) {
+						for (size_t j = 4; j < 8; ++j) {
+							pose[track].values[j] = -stack.poses[i - 1][track].values[j];
+						}
+					}
+				}
+				break;
+			default:
+				break;
+			}
+			stack.amounts.emplace_back(amount);
+		}
+
+		for (const auto& pose : stack.poses) {
+			stack.posePointers.emplace_back(pose.front().values);
+		}
+
+		return stack;
+	}
+
+	Pose Blend(BlendFunc a_func, const PoseStack& a_stack)
+	{
+		Pose result = a_stack.basePose;
+		a_func(a_stack.posePointers.data(), a_stack.trackCounts.data(), a_stack.amounts.data(), a_stack.poses.size(), a_stack.numTracks, result.front().values);
+		return result;
+	}
+
+	int RunEquivalenceTest()
+	{
+		constexpr size_t numStacks = 10000;
+		constexpr size_t maxPoses = 8;
+		constexpr uint32_t maxTracks = 160;
+
+		std::mt19937 rng(12345);
+		std::uniform_int_distribution<size_t> poseCountDistribution(1, maxPoses);
+		std::uniform_int_distribution<uint32_t> trackCountDistribution(1, maxTracks);
+
+		size_t numMismatches = 0;
+		for (size_t i = 0; i < numStacks; ++i) {
+			const auto stack = MakeRandomStack(rng, trackCountDistribution(rng), poseCountDistribution(rng));
+
+			const Pose simdResult = Blend(&PoseBlending::BlendPoseStack, stack);
+			const Pose scalarResult = Blend(&PoseBlending::BlendPoseStackScalar, stack);
+
+			if (std::memcmp(simdResult.data(), scalarResult.data(), simdResult.size() * sizeof(Transform)) != 0) {
+				if (numMismatches == 0) {
+					for (uint32_t track = 0; track < stack.numTracks; ++track) {
+						for (size_t j = 0; j < PoseBlending::kFloatsPerTransform; ++j) {
+							if (std::memcmp(&simdResult[track].values[j], &scalarResult[track].values[j], sizeof(float)) != 0) {
+								std::printf("first mismatch in stack %zu, track %u, float %zu: SSE %.9g, scalar %.9g\n", i, track, j, simdResult[track].values[j], scalarResult[track].values[j]);
+								track = stack.numTracks;
+								break;
+							}
+						}
+					}
+				}
+				++numMismatches;
+			}
+		}
+
+		if (numMismatches > 0) {
+			std::printf("FAILED: %zu of %zu pose stacks differ between the SSE and scalar blend\n", numMismatches, numStacks);
+			return 1;
+		}
+
+		std::printf("passed: %zu pose stacks blend bitwise identically\n", numStacks);
+		return 0;
+	}
+
+	double TimeBlend(BlendFunc a_func, const PoseStack& a_stack, size_t a_iterations)
+	{
+		Pose result = a_stack.basePose;
+
+		const auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < a_iterations; ++i) {
+			a_func(a_stack.posePointers.data(), a_stack.trackCounts.data(), a_stack.amounts.data(), a_stack.poses.size(), a_stack.numTracks, result.front().values);
+		}
+		const auto end = std::chrono::steady_clock::now();
+
+		// keep the result alive so the calls aren't optimized out
+		volatile float sink = result.front().values[0];
+		static_cast<void>(sink);
+
+		return std::chrono::duration<double, std::nano>(end - start).count() / static_cast<double>(a_iterations);
+	}
+
+	int RunBenchmark()
+	{
+		constexpr uint32_t numTracks = 128;  // roughly a humanoid skeleton
+		constexpr size_t iterations = 100000;
+
+		std::mt19937 rng(12345);
+
+		for (const size_t numPoses : { 1, 2, 4, 8 }) {
+			auto stack = MakeRandomStack(rng, numTracks, numPoses);
+			std::ranges::fill(stack.trackCounts, numTracks);
+
+			const double scalarTime = TimeBlend(&PoseBlending::BlendPoseStackScalar, stack, iterations);
+			const double simdTime = TimeBlend(&PoseBlending::BlendPoseStack, stack, iterations);
+
+			std::printf("%u tracks, %zu poses: scalar %.0f ns, SSE %.0f ns (%.2fx)\n", numTracks, numPoses, scalarTime, simdTime, scalarTime / simdTime);
+		}
+
+		return 0;
+	}
+}
+
+int main(int a_argc, char* a_argv[])
+{
+	if (a_argc > 1 && std::string_view(a_argv[1]) == "--benchmark") {
+		return RunBenchmark();
+	}
+
+	return RunEquivalenceTest();
+}